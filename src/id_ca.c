@@ -139,6 +139,8 @@ int32_t		chunkexplen;  // 4 bytes in data files; must not be long (8 bytes on 64
 
 SDMode		oldsoundmode;
 
+static	SDL_mutex	*cachelock;		// loading grsegs and audiosegs
+
 
 
 void	CAL_CarmackExpand (uint16_t *source, uint16_t *dest,
@@ -863,6 +865,10 @@ void CA_Startup (void)
 	CAL_SetupGrFile ();
 	CAL_SetupAudioFile ();
 
+	cachelock = SDL_CreateMutex ();
+	if (!cachelock)
+		Quit ("CA_Startup: Can't create lock!");
+
 	mapon = -1;
 	ca_levelbit = 1;
 	ca_levelnum = 0;
@@ -908,12 +914,19 @@ void CA_CacheAudioChunk (int chunk)
 	long	pos,compressed;
 	memptr  temp;
 
-	if (audiosegs[chunk])
+	if (SDL_AtomicGetPtr ((void **)&audiosegs[chunk]))
 	{
 		MM_SetPurge ((memptr *)&audiosegs[chunk],0);
 		return;							// allready in memory
 	}
 
+	SDL_LockMutex (cachelock);
+	if (audiosegs[chunk])
+	{
+		SDL_UnlockMutex (cachelock);
+		return;							// loaded while we waited
+	}
+
 //
 // load the chunk into a buffer, either the miscbuffer if it fits, or allocate
 // a larger buffer
@@ -925,11 +938,13 @@ void CA_CacheAudioChunk (int chunk)
 
 	temp = NULL;
 	MM_GetPtr (&temp,compressed);
-	audiosegs[chunk] = (byte *)temp;
-	if (mmerror)
-		return;
+	if (!mmerror)
+	{
+		CA_FarRead(audiohandle,(byte *)temp,compressed);
+		SDL_AtomicSetPtr ((void **)&audiosegs[chunk],temp);
+	}
 
-	CA_FarRead(audiohandle,audiosegs[chunk],compressed);
+	SDL_UnlockMutex (cachelock);
 }
 
 //===========================================================================
@@ -1000,6 +1015,7 @@ cachein:
 void CAL_ExpandGrChunk (int chunk, byte *source)
 {
 	long	expanded;
+	memptr	dest;
 
 
 	if (chunk >= STARTTILE8 && chunk < STARTEXTERNS)
@@ -1037,10 +1053,14 @@ void CAL_ExpandGrChunk (int chunk, byte *source)
 // allocate final space, decompress it, and free bigbuffer
 // Sprites need to have shifts made and various other junk
 //
-	MM_GetPtr (&grsegs[chunk],expanded);
+// the chunk only goes in grsegs once it's whole, since CA_CacheGrChunk
+// looks there without a lock
+//
+	MM_GetPtr (&dest,expanded);
 	if (mmerror)
 		return;
-	CAL_HuffExpand (source,(byte *)grsegs[chunk],expanded,grhuffman,false);
+	CAL_HuffExpand (source,(byte *)dest,expanded,grhuffman,false);
+	SDL_AtomicSetPtr (&grsegs[chunk],dest);
 }
 
 
@@ -1061,11 +1081,25 @@ void CA_CacheGrChunk (int chunk)
 	byte	*source;
 	int		next;
 
-	grneeded[chunk] |= ca_levelbit;		// make sure it doesn't get removed
-	if (grsegs[chunk])
+//
+// the level marks are the game's, which caches from one thread; the
+// library's instances come through here from every batch thread at once
+// and never change cache levels, so they leave the marks alone
+//
+	if (!vl_headless)
 	{
-		MM_SetPurge (&grsegs[chunk],0);
+		grneeded[chunk] |= ca_levelbit;	// make sure it doesn't get removed
+		if (grsegs[chunk])
+			MM_SetPurge (&grsegs[chunk],0);
+	}
+	if (SDL_AtomicGetPtr (&grsegs[chunk]))
 		return;							// allready in memory
+
+	SDL_LockMutex (cachelock);
+	if (grsegs[chunk])
+	{
+		SDL_UnlockMutex (cachelock);
+		return;							// loaded while we waited
 	}
 
 //
@@ -1074,7 +1108,10 @@ void CA_CacheGrChunk (int chunk)
 //
 	pos = GRFILEPOS(chunk);
 	if (pos<0)							// $FFFFFFFF start is a sparse tile
-	  return;
+	{
+		SDL_UnlockMutex (cachelock);
+		return;
+	}
 
 	next = chunk +1;
 	while (GRFILEPOS(next) == -1)		// skip past any sparse tiles
@@ -1101,6 +1138,8 @@ void CA_CacheGrChunk (int chunk)
 
 	if (compressed>BUFFERSIZE)
 		MM_FreePtr(&bigbufferseg);
+
+	SDL_UnlockMutex (cachelock);
 }
 
 
@@ -1257,6 +1296,60 @@ void CA_CacheMap (int mapnum)
 	}
 }
 
+
+/*
+======================
+=
+= CA_LoadMap
+=
+= Expands a map's planes into dest, MAPPLANES 64*64 planes in a row.  Game
+= instances each keep their own copy, since pushwalls edit it.  Unlike
+= CA_CacheMap this touches nothing shared: the file is read with pread
+= and the work buffers are the caller's own, so any number of threads
+= can load maps at once.
+=
+======================
+*/
+
+void CA_LoadMap (int mapnum, uint16_t *dest)
+{
+	long		pos,compressed;
+	int			plane;
+	uint16_t	*source;
+#ifdef CARMACIZED
+	uint16_t	*buffer2;
+	long		expanded;
+#endif
+
+	for (plane = 0; plane<MAPPLANES; plane++)
+	{
+		pos = mapheaderseg[mapnum]->planestart[plane];
+		compressed = mapheaderseg[mapnum]->planelength[plane];
+
+		source = malloc (compressed);
+		if (!source)
+			Quit ("CA_LoadMap: Out of memory!");
+		if (pread (maphandle,source,compressed,pos) != compressed)
+			Quit ("CA_LoadMap: Read error!");
+
+#ifdef CARMACIZED
+		expanded = *source;
+		buffer2 = malloc (expanded);
+		if (!buffer2)
+			Quit ("CA_LoadMap: Out of memory!");
+		CAL_CarmackExpand (source+1,buffer2,expanded);
+		CA_RLEWexpand (buffer2+1,dest+plane*64*64,64*64*2,
+		((mapfiletype *)tinf)->RLEWtag);
+		free (buffer2);
+#else
+		CA_RLEWexpand (source+1,dest+plane*64*64,64*64*2,
+		((mapfiletype *)tinf)->RLEWtag);
+#endif
+
+		free (source);
+	}
+}
+
 //===========================================================================
 
 /*
@@ -92,6 +92,7 @@ void CA_ClearAllMarks(void);
 
 void CA_CacheGrChunk(int chunk);
 void CA_CacheMap(int mapnum);
+void CA_LoadMap(int mapnum, uint16_t *dest);
 
 void CA_CacheMarks(void);
 
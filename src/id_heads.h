@@ -78,7 +78,7 @@ void	Quit (char *error);
 
 #define	UPDATETERMINATE	0x0301
 
-extern	unsigned	mapwidth,mapheight,tics;
+extern	unsigned	mapwidth,mapheight;
 extern	boolean		compatability;
 
 extern	byte		*updateptr;
@@ -257,11 +257,17 @@ void IN_PumpEvents(void)
 			}
 			break;
 
+		case SDL_WINDOWEVENT:
+			VL_ForcePresent();      // exposed or resized while the screen is still
+			break;
+
 		case SDL_QUIT:
 			Quit(NULL);
 			break;
 		}
 	}
+
+	VL_ShowFrame();     // anything converted since the last present
 }
 
 //==========================================================================
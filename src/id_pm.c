@@ -1,6 +1,11 @@
 // ID_PM.C - Page manager (macOS/SDL2 port)
 //
 // Loads VSWAP data from disk and caches pages in memory.
+//
+// Pages never change once loaded and are shared by every game instance in
+// the process.  A page is loaded the first time any thread asks for it and
+// published with a compare-and-swap, so PM_GetPage takes no lock: a thread
+// that loses the race to load a page frees its copy and uses the winner's.
 
 #include "id_heads.h"
 #include <ctype.h>
@@ -134,13 +139,14 @@ memptr PM_GetPageAddress(int pagenum)
 memptr PM_GetPage(int pagenum)
 {
 	word  length;
-	void *buf;
+	void *buf, *page;
 
 	if (pagenum >= ChunksInFile)
 		Quit("PM_GetPage: Invalid page request");
 
-	if (PageCache[pagenum])
-		return PageCache[pagenum];
+	page = SDL_AtomicGetPtr(&PageCache[pagenum]);
+	if (page)
+		return page;
 
 	if (!PageOffsets[pagenum])
 		Quit("PM_GetPage: Tried to load a sparse page!");
@@ -155,12 +161,15 @@ memptr PM_GetPage(int pagenum)
 
 	memset(buf, 0, PMPageSize);
 
-	if (lseek(PageFile, PageOffsets[pagenum], SEEK_SET) == -1)
-		Quit("PM_GetPage: Seek failed");
+	if (pread(PageFile, buf, length, PageOffsets[pagenum]) == -1)
+		Quit("PM_GetPage: Read failed");
 
-	read(PageFile, buf, length);
+	if (!SDL_AtomicCASPtr(&PageCache[pagenum], NULL, buf))
+	{
+		free(buf);		// another thread got there first
+		return SDL_AtomicGetPtr(&PageCache[pagenum]);
+	}
 
-	PageCache[pagenum] = buf;
 	return buf;
 }
 
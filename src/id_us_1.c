@@ -26,7 +26,7 @@
 //			window
 //
 
-#include "id_heads.h"
+#include "wl_def.h"
 #include <time.h>
 
 //
@@ -36,8 +36,8 @@ byte backcolor;
 
 //
 // Table-driven pseudo-random number generator (from ID_US_A.ASM)
+// The table position is rndindex in the game instance
 //
-static int rndindex;
 
 static byte rndtable[256] = {
 	  0,   8, 109, 220, 222, 241, 149, 107,  75, 248, 254, 140,  16,  66,
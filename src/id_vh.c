@@ -251,121 +251,172 @@ void LoadLatchMem(void)
 
 //==========================================================================
 // FizzleFade - LFSR-based screen transition effect
+//
+// The dissolve is timed by TimeCount, not by frames: each frame shows as
+// many pixels as the time since it started calls for.  FizzleBegin and
+// FizzleFrame run it over whatever is drawn each frame, so the game can
+// go on underneath; FizzleFade is the old blocking form for a still
+// screen.
 //==========================================================================
 
-boolean FizzleFade(unsigned source, unsigned dest,
-	unsigned width, unsigned height, unsigned frames, boolean abortable)
+boolean fizzling;                   // FizzleFrame has pixels left to show
+
+static byte *fizzlemask;            // width*height, nonzero once shown
+static byte *fizzlescreen;          // the screen FizzleFade reveals
+static unsigned fizzlex, fizzley, fizzlewidth, fizzleheight;
+static unsigned fizzlernd, fizzlecount, fizzletotal, fizzleframes;
+static longword fizzlestart;
+
+void FizzleBegin(unsigned dest, unsigned width, unsigned height, unsigned frames)
 {
-	unsigned pixperframe;
-	unsigned rndval = 1;
-	longword frame;
-	int p;
-	unsigned x, y;
-	longword lastframe;
-	byte *newscreen;
-	int destx, desty;
+	if (!fizzlemask)
+	{
+		fizzlemask = (byte *)malloc(320 * 200);
+		fizzlescreen = (byte *)malloc(320 * 200);
+		if (!fizzlemask || !fizzlescreen)
+			Quit("FizzleBegin: Out of memory!");
+	}
 
-	(void)source;
+	fizzlex = dest % 320;
+	fizzley = dest / 320;
+	if (fizzley >= 200)
+		fizzley = 200;
+	fizzlewidth = fizzlex + width <= 320 ? width : 320 - fizzlex;
+	fizzleheight = fizzley + height <= 200 ? height : 200 - fizzley;
+
+	fizzletotal = fizzlewidth * fizzleheight;
+	memset(fizzlemask, 0, fizzletotal);
+	fizzlernd = 1;
+	fizzlecount = 0;
+	fizzleframes = frames ? frames : 1;
+	fizzlestart = TimeCount;
+	fizzling = fizzletotal != 0;
+}
 
-	// Compute the top-left corner of the dest region in the framebuffer
-	desty = dest / 320;
-	destx = dest % 320;
+/*
+======================
+=
+= FizzleReveal
+=
+= Marks pixels shown until count are.  The 17 bit LFSR visits every value
+= up to 131071 once, more than the 64000 pixels of a screen.
+=
+======================
+*/
+
+static void FizzleReveal(unsigned count)
+{
+	unsigned lsb;
 
-	// Save the new content that's already in the framebuffer
-	newscreen = (byte *)malloc(width * height);
-	if (!newscreen)
+	while (fizzlecount < count)
+	{
+		do
+		{
+			lsb = fizzlernd & 1;
+			fizzlernd >>= 1;
+			if (lsb)
+				fizzlernd ^= 0x00012000;
+		} while (fizzlernd - 1 >= fizzletotal);
+
+		fizzlemask[fizzlernd - 1] = 1;
+		fizzlecount++;
+	}
+}
+
+/*
+======================
+=
+= FizzleFrame
+=
+= Blacks out the pixels of the frame just drawn that aren't shown yet.
+= Returns false once everything is.
+=
+======================
+*/
+
+boolean FizzleFrame(void)
+{
+	longword elapsed;
+	unsigned x, y;
+	byte *mask, *dest;
+
+	if (!fizzling)
 		return false;
 
-	for (y = 0; y < height; y++)
+	if (TimeCount < fizzlestart)
+		fizzlestart = TimeCount;    // the clock was reset under it
+	elapsed = TimeCount - fizzlestart;
+
+	if (vl_headless || elapsed >= fizzleframes)
+		FizzleReveal(fizzletotal);
+	else
+		FizzleReveal((unsigned)((long long)fizzletotal * elapsed / fizzleframes));
+
+	if (fizzlecount == fizzletotal)
 	{
-		int sy = desty + y;
-		if (sy < 200)
-			memcpy(&newscreen[y * width],
-				   &sdl_framebuffer[sy * 320 + destx],
-				   (destx + width <= 320) ? width : 320 - destx);
+		fizzling = false;
+		return false;
 	}
 
-	// Fill the dest region with black to start the dissolve
-	for (y = 0; y < height; y++)
+	mask = fizzlemask;
+	for (y = 0; y < fizzleheight; y++)
 	{
-		int sy = desty + y;
-		if (sy < 200)
-			memset(&sdl_framebuffer[sy * 320 + destx], 0,
-				   (destx + width <= 320) ? width : 320 - destx);
+		dest = &sdl_framebuffer[(fizzley + y) * 320 + fizzlex];
+		for (x = 0; x < fizzlewidth; x++)
+			if (!mask[x])
+				dest[x] = 0;
+		mask += fizzlewidth;
 	}
-	VL_Present();
 
-	pixperframe = (width * height) / frames;
-	lastframe = TimeCount;
+	return true;
+}
+
+/*
+======================
+=
+= FizzleFade
+=
+= Dissolves to what's on the screen now, one presented frame at a time
+=
+======================
+*/
 
-	for (frame = 0; frame < frames; frame++)
+boolean FizzleFade(unsigned source, unsigned dest,
+	unsigned width, unsigned height, unsigned frames, boolean abortable)
+{
+	boolean more, aborted;
+	unsigned y;
+
+	(void)source;
+
+	FizzleBegin(dest, width, height, frames);
+
+	// Save the new content that's already in the framebuffer
+	for (y = 0; y < fizzleheight; y++)
+		memcpy(&fizzlescreen[y * fizzlewidth],
+			   &sdl_framebuffer[(fizzley + y) * 320 + fizzlex], fizzlewidth);
+
+	aborted = false;
+	do
 	{
 		if (abortable)
 		{
 			IN_PumpEvents();
 			if (LastScan)
 			{
-				// Reveal remaining pixels immediately
-				for (y = 0; y < height; y++)
-				{
-					int sy = desty + y;
-					if (sy < 200)
-						memcpy(&sdl_framebuffer[sy * 320 + destx],
-							   &newscreen[y * width],
-							   (destx + width <= 320) ? width : 320 - destx);
-				}
-				free(newscreen);
-				VL_Present();
-				return true;
+				aborted = true;
+				fizzling = false;   // reveal remaining pixels immediately
 			}
 		}
 
-		for (p = 0; p < (int)pixperframe; p++)
-		{
-			// Galois LFSR for pseudo-random pixel ordering
-			do
-			{
-				// 17-bit LFSR
-				unsigned lsb = rndval & 1;
-				rndval >>= 1;
-				if (lsb)
-					rndval ^= 0x00012000;
-
-				x = (rndval - 1) % 320;
-				y = (rndval - 1) / 320;
-			} while (rndval - 1 >= width * height);
-
-			if (x < width && y < height)
-			{
-				int sx = destx + x;
-				int sy = desty + y;
-				if (sx < 320 && sy < 200)
-					sdl_framebuffer[sy * 320 + sx] = newscreen[y * width + x];
-			}
-
-			if (rndval == 1)
-				break; // full cycle completed
-		}
-
-		// Wait for frame timing
-		while (TimeCount - lastframe < 1)
-			SDL_Delay(1);
-		lastframe = TimeCount;
+		for (y = 0; y < fizzleheight; y++)
+			memcpy(&sdl_framebuffer[(fizzley + y) * 320 + fizzlex],
+				   &fizzlescreen[y * fizzlewidth], fizzlewidth);
 
+		more = FizzleFrame();
 		VL_Present();
-	}
-
-	// Ensure all pixels are revealed
-	for (y = 0; y < height; y++)
-	{
-		int sy = desty + y;
-		if (sy < 200)
-			memcpy(&sdl_framebuffer[sy * 320 + destx],
-				   &newscreen[y * width],
-				   (destx + width <= 320) ? width : 320 - destx);
-	}
-	free(newscreen);
-	VL_Present();
+		VL_WaitPresent();
+	} while (more);
 
-	return false;
+	return aborted;
 }
@@ -117,6 +117,9 @@ void LatchDrawPic(unsigned x, unsigned y, unsigned picnum);
 void LoadLatchMem(void);
 boolean FizzleFade(unsigned source, unsigned dest,
 	unsigned width, unsigned height, unsigned frames, boolean abortable);
+void FizzleBegin(unsigned dest, unsigned width, unsigned height, unsigned frames);
+boolean FizzleFrame(void);
+extern boolean fizzling;
 
 #define NUMLATCHPICS 100
 extern unsigned latchpics[NUMLATCHPICS];
@@ -4,8 +4,25 @@
 // renderer, and streaming texture. The game draws into a flat
 // 320x200 indexed-color framebuffer which is palette-converted
 // and uploaded to the GPU each frame via VL_Present().
+//
+// Without an accelerated renderer (or with vl_surfacepresent set) the
+// converted frame goes straight into the window surface instead,
+// integer scaled, and only the rows that changed.
+//
+// The palette lookup happens on its own thread.  sdl_framebuffer is one
+// of three frames; VL_Present hands it over tagged with the palette it
+// was drawn for and carries on drawing into another, and the convert
+// thread turns whichever frame is newest into 32 bit pixels.  A frame it
+// hasn't got to is simply replaced.  The renderer and the window stay on
+// the main thread, as macOS requires: it shows the newest converted frame
+// from VL_Present, VL_WaitPresent and the input pump.  The main thread is
+// also the game's, so the renderer is made without vsync and a present
+// never waits for the display.
 
 #include "id_heads.h"
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
 
 //==========================================================================
 
@@ -25,9 +42,50 @@ SDL_Window   *sdl_window;
 SDL_Renderer *sdl_renderer;
 SDL_Texture  *sdl_texture;
 byte         *sdl_framebuffer;   // 320x200 indexed
+boolean      vl_headless;        // draw into sdl_framebuffer, never show it
+boolean      vl_surfacepresent;  // present to the window surface, no renderer
 
 static SDL_Color sdl_palette[256];
-static uint32_t  sdl_rgbapal[256]; // pre-computed ARGB
+static byte      *vl_shift;        // VL_SetShift palette, shown in its place
+static unsigned  palserial = 1;    // bumped on every palette change
+
+// triple buffering
+typedef struct
+{
+	byte      *pixels;             // 320x200 indexed
+	SDL_Color palette[256];        // what it's shown with
+	unsigned  palserial;
+} vlframe_t;
+
+static vlframe_t vl_frames[3];
+static int       drawframe;        // sdl_framebuffer, the game's
+static int       readyframe;       // the newest finished frame
+static int       convertframe;     // the convert thread's
+static boolean   frameready;       // readyframe hasn't been converted
+static int       lastpresented = -1; // the frame last handed over, -1 to force one
+static boolean   presentdropped;   // VL_Present found nothing new
+
+// the same three ways round for the converted frames
+static uint32_t  *vl_argb[3];      // 320x200 0xAARRGGBB
+static int       convertargb;      // the convert thread's
+static int       doneargb;         // the newest converted frame
+static int       showargb;         // the main thread's
+static boolean   argbready;        // doneargb hasn't been shown
+static boolean   converting;       // the convert thread has a frame
+
+static SDL_Thread *convertthread;
+static SDL_mutex *presentlock;
+static SDL_cond  *presentcond;
+static boolean   presentquit;
+
+static uint32_t  presentpal[256];  // ARGB, the convert thread's
+
+// window surface presentation
+static SDL_Surface *lastsurface;   // the surface lastframe was drawn to
+static int       surfacew, surfaceh;
+static int       surfacescale;     // 1-4 window pixels per game pixel
+static int       surfacex, surfacey; // where the game screen starts
+static uint32_t  *lastframe;       // what the window shows now
 
 // Latch memory -- a block of RAM that replaces VGA off-screen memory
 // used by LoadLatchMem / VL_LatchToScreen
@@ -35,22 +93,81 @@ byte *vl_latchmem;
 
 //==========================================================================
 
-void VL_Startup(void)
+/*
+======================
+=
+= VL_OpenSurface
+=
+= Only 32 bit RGB surfaces are handled, so converted frames go in as they
+= are; anything else gets a renderer
+=
+======================
+*/
+
+static boolean VL_OpenSurface(void)
 {
-	int i;
+	SDL_Surface *surface;
+
+	surface = SDL_GetWindowSurface(sdl_window);
+	if (!surface || surface->format->BytesPerPixel != 4
+		|| surface->format->Rmask != 0xFF0000
+		|| surface->format->Gmask != 0x00FF00
+		|| surface->format->Bmask != 0x0000FF)
+		return false;
 
-	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_AUDIO) < 0)
-		Quit("VL_Startup: SDL_Init failed");
+	lastframe = (uint32_t *)malloc(320 * 200 * sizeof(uint32_t));
+	if (!lastframe)
+		return false;
 
+	lastsurface = NULL;
+	return true;
+}
+
+/*
+======================
+=
+= VL_OpenWindow
+=
+======================
+*/
+
+static void VL_OpenWindow(void)
+{
 	sdl_window = SDL_CreateWindow(
 		"Wolfenstein 3D",
 		SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
 		960, 600, 0);
 	if (!sdl_window)
 		Quit("VL_Startup: SDL_CreateWindow failed");
+}
+
+/*
+======================
+=
+= VL_OpenRenderer
+=
+= The renderer and the window surface belong to the main thread, which
+= is the only one macOS lets draw to a window.  That's the thread the game
+= runs on, so there's no PRESENTVSYNC: SDL_RenderPresent would sit out
+= the display's refresh in the middle of the play loop.  A frame can tear
+= instead.
+=
+======================
+*/
+
+static void VL_OpenRenderer(void)
+{
+	if (!vl_surfacepresent)
+		sdl_renderer = SDL_CreateRenderer(sdl_window, -1,
+			SDL_RENDERER_ACCELERATED);
+
+	//
+	// SDL's software renderer scales every copy generically, so without
+	// a GPU the window surface is cheaper
+	//
+	if (!sdl_renderer && VL_OpenSurface())
+		return;
 
-	sdl_renderer = SDL_CreateRenderer(sdl_window, -1,
-		SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
 	if (!sdl_renderer)
 		sdl_renderer = SDL_CreateRenderer(sdl_window, -1, 0);
 	if (!sdl_renderer)
@@ -64,8 +181,92 @@ void VL_Startup(void)
 		320, 200);
 	if (!sdl_texture)
 		Quit("VL_Startup: SDL_CreateTexture failed");
+}
+
+/*
+======================
+=
+= VL_CloseRenderer
+=
+======================
+*/
+
+static void VL_CloseRenderer(void)
+{
+	if (lastframe)    { free(lastframe);    lastframe = NULL; }
+	if (sdl_texture)  { SDL_DestroyTexture(sdl_texture);   sdl_texture = NULL; }
+	if (sdl_renderer) { SDL_DestroyRenderer(sdl_renderer); sdl_renderer = NULL; }
+}
+
+static int VL_ConvertThread(void *data);
+
+/*
+======================
+=
+= VL_StartPresent
+=
+= Opens the renderer and sets up the frames on both sides of the convert
+= thread
+=
+======================
+*/
+
+static void VL_StartPresent(void)
+{
+	int i;
+
+	VL_OpenRenderer();
+
+	for (i = 0; i < 3; i++)
+	{
+		vl_frames[i].pixels = (byte *)calloc(320 * 200, 1);
+		vl_argb[i] = (uint32_t *)calloc(320 * 200, sizeof(uint32_t));
+		if (!vl_frames[i].pixels || !vl_argb[i])
+			Quit("VL_Startup: Failed to allocate framebuffer");
+	}
+	drawframe = 0;
+	readyframe = 1;
+	convertframe = 2;
+	frameready = false;
+	lastpresented = -1;
+	sdl_framebuffer = vl_frames[drawframe].pixels;
+
+	convertargb = 0;
+	doneargb = 1;
+	showargb = 2;
+	argbready = converting = false;
+
+	presentlock = SDL_CreateMutex();
+	presentcond = SDL_CreateCond();
+	if (!presentlock || !presentcond)
+		Quit("VL_Startup: Can't create present lock");
+
+	presentquit = false;
+	convertthread = SDL_CreateThread(VL_ConvertThread, "convert", NULL);
+	if (!convertthread)
+		Quit("VL_Startup: Can't create convert thread");
+}
+
+void VL_Startup(void)
+{
+	int i;
+
+	if (vl_headless)
+	{
+		if (SDL_Init(SDL_INIT_TIMER) < 0)
+			Quit("VL_Startup: SDL_Init failed");
+	}
+	else
+	{
+		if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_AUDIO) < 0)
+			Quit("VL_Startup: SDL_Init failed");
+
+		VL_OpenWindow();
+		VL_StartPresent();
+	}
 
-	sdl_framebuffer = (byte *)calloc(320 * 200, 1);
+	if (!sdl_framebuffer)
+		sdl_framebuffer = (byte *)calloc(320 * 200, 1);
 	if (!sdl_framebuffer)
 		Quit("VL_Startup: Failed to allocate framebuffer");
 
@@ -83,8 +284,8 @@ void VL_Startup(void)
 	{
 		sdl_palette[i].r = sdl_palette[i].g = sdl_palette[i].b = (byte)i;
 		sdl_palette[i].a = 255;
-		sdl_rgbapal[i] = 0xFF000000 | (i << 16) | (i << 8) | i;
 	}
+	palserial++;
 
 	screenfaded = false;
 	bufferofs = 0;
@@ -95,33 +296,448 @@ void VL_Startup(void)
 
 void VL_Shutdown(void)
 {
+	int i;
+
+	if (convertthread)
+	{
+		SDL_LockMutex(presentlock);
+		presentquit = true;
+		SDL_CondBroadcast(presentcond);
+		SDL_UnlockMutex(presentlock);
+
+		SDL_WaitThread(convertthread, NULL);
+		convertthread = NULL;
+
+		for (i = 0; i < 3; i++)
+		{
+			free(vl_frames[i].pixels);
+			vl_frames[i].pixels = NULL;
+			free(vl_argb[i]);
+			vl_argb[i] = NULL;
+		}
+		sdl_framebuffer = NULL;
+	}
+	if (presentcond)  { SDL_DestroyCond(presentcond);   presentcond = NULL; }
+	if (presentlock)  { SDL_DestroyMutex(presentlock);  presentlock = NULL; }
+
+	VL_CloseRenderer();
 	if (vl_latchmem)  { free(vl_latchmem);  vl_latchmem = NULL; }
 	if (sdl_framebuffer) { free(sdl_framebuffer); sdl_framebuffer = NULL; }
-	if (sdl_texture)  { SDL_DestroyTexture(sdl_texture);   sdl_texture = NULL; }
-	if (sdl_renderer) { SDL_DestroyRenderer(sdl_renderer); sdl_renderer = NULL; }
 	if (sdl_window)   { SDL_DestroyWindow(sdl_window);     sdl_window = NULL; }
 	SDL_Quit();
 }
 
 //==========================================================================
 
-void VL_Present(void)
+/*
+======================
+=
+= VL_ScaleRow
+=
+= Integer scaling of one converted 320 pixel row into the window surface.
+=
+= The palette lookup isn't done here.  It's the convert thread's, while
+= the window surface may only be touched from the main thread, so the
+= lookup and the scaling are two passes on two threads; the main thread
+= is left only this copy.  With NEON, four pixels are loaded at a time
+= and stored interleaved with themselves, scale times each.
+=
+======================
+*/
+
+static void VL_ScaleRow(uint32_t *dest, const uint32_t *src, int scale)
+{
+#ifdef __ARM_NEON
+	uint32x4_t v;
+#else
+	uint32_t c;
+#endif
+	int x;
+
+	if (scale == 1)
+	{
+		memcpy(dest, src, 320 * sizeof(uint32_t));
+		return;
+	}
+
+#ifdef __ARM_NEON
+	for (x = 0; x < 320; x += 4, dest += 4 * scale)
+	{
+		v = vld1q_u32(src + x);
+		switch (scale)
+		{
+		case 2:
+			vst2q_u32(dest, ((uint32x4x2_t){{v, v}}));
+			break;
+		case 3:
+			vst3q_u32(dest, ((uint32x4x3_t){{v, v, v}}));
+			break;
+		default:
+			vst4q_u32(dest, ((uint32x4x4_t){{v, v, v, v}}));
+			break;
+		}
+	}
+#else
+	switch (scale)
+	{
+	case 2:
+		for (x = 0; x < 320; x++)
+		{
+			c = src[x];
+			dest[x * 2] = c;
+			dest[x * 2 + 1] = c;
+		}
+		break;
+
+	case 3:
+		for (x = 0; x < 320; x++)
+		{
+			c = src[x];
+			dest[x * 3] = c;
+			dest[x * 3 + 1] = c;
+			dest[x * 3 + 2] = c;
+		}
+		break;
+
+	default:
+		for (x = 0; x < 320; x++)
+		{
+			c = src[x];
+			dest[x * 4] = c;
+			dest[x * 4 + 1] = c;
+			dest[x * 4 + 2] = c;
+			dest[x * 4 + 3] = c;
+		}
+		break;
+	}
+#endif
+}
+
+/*
+======================
+=
+= VL_PresentSurface
+=
+= Rows that match what the window already shows are skipped, and the
+= window is only told about the bands of rows that were redrawn
+=
+======================
+*/
+
+static void VL_PresentSurface(const uint32_t *pixels)
 {
-	uint32_t *pixels;
-	int pitch, i;
+	SDL_Surface *surface;
+	SDL_Rect rects[100];            // bands are at least a row apart
+	int numrects, top, y, i;
+	boolean all, dirty;
+	const uint32_t *src;
+	uint32_t *last, *dest;
+
+	surface = SDL_GetWindowSurface(sdl_window);
+	if (!surface)
+		return;
+
+	all = false;
+	if (surface != lastsurface || surface->w != surfacew || surface->h != surfaceh)
+	{
+		lastsurface = surface;
+		surfacew = surface->w;
+		surfaceh = surface->h;
+
+		surfacescale = surfacew / 320 < surfaceh / 200 ? surfacew / 320 : surfaceh / 200;
+		if (surfacescale < 1)
+			surfacescale = 1;
+		if (surfacescale > 4)
+			surfacescale = 4;
+		surfacex = (surfacew - 320 * surfacescale) / 2;
+		surfacey = (surfaceh - 200 * surfacescale) / 2;
+		if (surfacex < 0 || surfacey < 0)
+		{
+			lastsurface = NULL;     // window smaller than the screen
+			return;
+		}
+
+		SDL_FillRect(surface, NULL, SDL_MapRGB(surface->format, 0, 0, 0));
+		all = true;
+	}
 
-	if (SDL_LockTexture(sdl_texture, NULL, (void **)&pixels, &pitch) < 0)
+	if (SDL_MUSTLOCK(surface) && SDL_LockSurface(surface) < 0)
 		return;
 
-	for (i = 0; i < 320 * 200; i++)
-		pixels[i] = sdl_rgbapal[sdl_framebuffer[i]];
+	numrects = 0;
+	top = -1;
+	src = pixels;
+	last = lastframe;
+	for (y = 0; y <= 200; y++, src += 320, last += 320)
+	{
+		dirty = y < 200 && (all || memcmp(src, last, 320 * sizeof(uint32_t)));
+		if (dirty)
+		{
+			memcpy(last, src, 320 * sizeof(uint32_t));
+
+			dest = (uint32_t *)((byte *)surface->pixels
+				+ (surfacey + y * surfacescale) * surface->pitch) + surfacex;
+			VL_ScaleRow(dest, src, surfacescale);
+			for (i = 1; i < surfacescale; i++)
+				memcpy((byte *)dest + i * surface->pitch, dest,
+					320 * surfacescale * sizeof(uint32_t));
+
+			if (top < 0)
+				top = y;
+		}
+		else if (top >= 0)
+		{
+			rects[numrects].x = surfacex;
+			rects[numrects].y = surfacey + top * surfacescale;
+			rects[numrects].w = 320 * surfacescale;
+			rects[numrects].h = (y - top) * surfacescale;
+			numrects++;
+			top = -1;
+		}
+	}
+
+	if (SDL_MUSTLOCK(surface))
+		SDL_UnlockSurface(surface);
+
+	if (all)
+		SDL_UpdateWindowSurface(sdl_window);   // borders too after a clear
+	else if (numrects)
+		SDL_UpdateWindowSurfaceRects(sdl_window, rects, numrects);
+}
+
+/*
+======================
+=
+= VL_PresentTexture
+=
+======================
+*/
+
+static void VL_PresentTexture(const uint32_t *pixels)
+{
+	if (SDL_UpdateTexture(sdl_texture, NULL, pixels, 320 * sizeof(uint32_t)) < 0)
+		return;
 
-	SDL_UnlockTexture(sdl_texture);
 	SDL_RenderClear(sdl_renderer);
 	SDL_RenderCopy(sdl_renderer, sdl_texture, NULL, NULL);
 	SDL_RenderPresent(sdl_renderer);
 }
 
+/*
+======================
+=
+= VL_ConvertThread
+=
+= Takes the newest frame whenever there is one and looks its palette up
+= into 32 bit pixels.  It never calls SDL's video functions; showing the
+= result is left to the main thread.
+=
+======================
+*/
+
+static int VL_ConvertThread(void *data)
+{
+	vlframe_t *frame;
+	uint32_t *dest;
+	unsigned convertedserial;
+	int i;
+
+	(void)data;
+
+	convertedserial = 0;
+	SDL_LockMutex(presentlock);
+	for (;;)
+	{
+		while (!frameready && !presentquit)
+			SDL_CondWait(presentcond, presentlock);
+		if (presentquit)
+			break;
+
+		i = convertframe;
+		convertframe = readyframe;
+		readyframe = i;
+		frameready = false;
+		converting = true;
+		SDL_UnlockMutex(presentlock);
+
+		frame = &vl_frames[convertframe];
+		if (frame->palserial != convertedserial)
+		{
+			for (i = 0; i < 256; i++)
+				presentpal[i] = 0xFF000000 |
+					((uint32_t)frame->palette[i].r << 16) |
+					((uint32_t)frame->palette[i].g << 8) |
+					(uint32_t)frame->palette[i].b;
+			convertedserial = frame->palserial;
+		}
+
+		dest = vl_argb[convertargb];
+		for (i = 0; i < 320 * 200; i++)
+			dest[i] = presentpal[frame->pixels[i]];
+
+		SDL_LockMutex(presentlock);
+		i = doneargb;
+		doneargb = convertargb;
+		convertargb = i;
+		argbready = true;
+		converting = false;
+		SDL_CondBroadcast(presentcond);     // for VL_WaitPresent
+	}
+	SDL_UnlockMutex(presentlock);
+
+	return 0;
+}
+
+/*
+======================
+=
+= VL_ShowFrame
+=
+= Shows the newest converted frame if it hasn't been yet.  Called from
+= the main thread wherever it hands over a frame, waits or reads input.
+=
+======================
+*/
+
+void VL_ShowFrame(void)
+{
+	int i;
+
+	if (!convertthread)
+		return;
+
+	SDL_LockMutex(presentlock);
+	if (!argbready)
+	{
+		SDL_UnlockMutex(presentlock);
+		return;
+	}
+	i = showargb;
+	showargb = doneargb;
+	doneargb = i;
+	argbready = false;
+	SDL_UnlockMutex(presentlock);
+
+	if (sdl_renderer)
+		VL_PresentTexture(vl_argb[showargb]);
+	else
+		VL_PresentSurface(vl_argb[showargb]);
+}
+
+/*
+======================
+=
+= VL_Present
+=
+= Hands the finished frame to the convert thread, and shows whatever it
+= finished since last time.  The game carries on in another frame that
+= starts as a copy of it, since most of the screen is only drawn when it
+= changes.
+=
+= A frame with the same pixels and palette as the last one handed over is
+= dropped, so a still screen costs a compare instead of an upload.  The
+= frame last handed over is only written again once it comes back around
+= as the draw frame, so it can be read here while it's being converted.
+=
+======================
+*/
+
+void VL_Present(void)
+{
+	vlframe_t *frame;
+	int i;
+
+	if (vl_headless)
+		return;
+
+	VL_ShowFrame();
+
+	frame = &vl_frames[drawframe];
+	if (frame->palserial != palserial)
+	{
+		if (vl_shift)
+		{
+			for (i = 0; i < 256; i++)
+			{
+				frame->palette[i].r = vl_shift[i * 3 + 0] * 255 / 63;
+				frame->palette[i].g = vl_shift[i * 3 + 1] * 255 / 63;
+				frame->palette[i].b = vl_shift[i * 3 + 2] * 255 / 63;
+			}
+		}
+		else
+			memcpy(frame->palette, sdl_palette, sizeof(sdl_palette));
+		frame->palserial = palserial;
+	}
+
+	if (lastpresented != -1
+		&& vl_frames[lastpresented].palserial == frame->palserial
+		&& !memcmp(vl_frames[lastpresented].pixels, frame->pixels, 320 * 200))
+	{
+		presentdropped = true;
+		return;
+	}
+	presentdropped = false;
+
+	SDL_LockMutex(presentlock);
+	i = drawframe;
+	drawframe = readyframe;
+	readyframe = i;
+	lastpresented = i;
+	frameready = true;
+	SDL_CondBroadcast(presentcond);
+	SDL_UnlockMutex(presentlock);
+
+	sdl_framebuffer = vl_frames[drawframe].pixels;
+	memcpy(sdl_framebuffer, frame->pixels, 320 * 200);
+}
+
+/*
+======================
+=
+= VL_ForcePresent
+=
+= The next VL_Present goes through even if nothing changed, for when the
+= window needs drawing again
+=
+======================
+*/
+
+void VL_ForcePresent(void)
+{
+	lastpresented = -1;
+}
+
+/*
+======================
+=
+= VL_WaitPresent
+=
+= Waits for the convert thread to finish the frame VL_Present handed it
+= and shows it, so a run of presented frames each gets on the screen
+=
+======================
+*/
+
+void VL_WaitPresent(void)
+{
+	if (!convertthread)
+		return;
+
+	if (presentdropped)
+	{
+		SDL_Delay(1);           // nothing was handed over to wait on
+		VL_ShowFrame();
+		return;
+	}
+
+	SDL_LockMutex(presentlock);
+	while ((frameready || converting) && !presentquit)
+		SDL_CondWait(presentcond, presentlock);
+	SDL_UnlockMutex(presentlock);
+
+	VL_ShowFrame();
+}
+
 //==========================================================================
 
 void VL_SetVGAPlaneMode(void)
@@ -152,6 +768,7 @@ void VL_SetSplitScreen(int linenum)
 
 void VL_WaitVBL(int vbls)
 {
+	VL_WaitPresent();           // up on the screen before holding it there
 	SDL_Delay(vbls * 1000 / 70);
 }
 
@@ -170,14 +787,10 @@ void VL_SetScreen(int crtc, int pel)
 // Palette
 //==========================================================================
 
-static void UpdateRGBAPalette(void)
+// frames take a copy of the palette the next time they're presented
+static void PaletteChanged(void)
 {
-	int i;
-	for (i = 0; i < 256; i++)
-		sdl_rgbapal[i] = 0xFF000000 |
-			((uint32_t)sdl_palette[i].r << 16) |
-			((uint32_t)sdl_palette[i].g << 8) |
-			(uint32_t)sdl_palette[i].b;
+	palserial++;
 }
 
 void VL_FillPalette(int red, int green, int blue)
@@ -189,7 +802,7 @@ void VL_FillPalette(int red, int green, int blue)
 		sdl_palette[i].g = green;
 		sdl_palette[i].b = blue;
 	}
-	UpdateRGBAPalette();
+	PaletteChanged();
 }
 
 void VL_SetColor(int color, int red, int green, int blue)
@@ -197,8 +810,7 @@ void VL_SetColor(int color, int red, int green, int blue)
 	sdl_palette[color].r = red;
 	sdl_palette[color].g = green;
 	sdl_palette[color].b = blue;
-	sdl_rgbapal[color] = 0xFF000000 |
-		((uint32_t)red << 16) | ((uint32_t)green << 8) | (uint32_t)blue;
+	PaletteChanged();
 }
 
 void VL_GetColor(int color, int *red, int *green, int *blue)
@@ -211,6 +823,9 @@ void VL_GetColor(int color, int *red, int *green, int *blue)
 void VL_SetPalette(byte *palette)
 {
 	int i;
+
+	vl_shift = NULL;
+	fading = false;
 	for (i = 0; i < 256; i++)
 	{
 		// Original VGA palette is 6-bit (0-63), scale to 8-bit
@@ -218,7 +833,7 @@ void VL_SetPalette(byte *palette)
 		sdl_palette[i].g = palette[i * 3 + 1] * 255 / 63;
 		sdl_palette[i].b = palette[i * 3 + 2] * 255 / 63;
 	}
-	UpdateRGBAPalette();
+	PaletteChanged();
 	screenfaded = false;
 }
 
@@ -233,64 +848,198 @@ void VL_GetPalette(byte *palette)
 	}
 }
 
-void VL_FadeOut(int start, int end, int red, int green, int blue, int steps)
+/*
+======================
+=
+= VL_SetShift
+=
+= Shows palette in place of the real one from the next VL_Present on,
+= NULL to go back.  Nothing is converted until a frame is presented, so
+= the palette flashes can change it every tic for free.
+=
+======================
+*/
+
+void VL_SetShift(byte *palette)
 {
-	int i, j;
-	byte origpal[256 * 3];
+	if (palette == vl_shift)
+		return;
 
-	VL_GetPalette(origpal);
+	vl_shift = palette;
+	PaletteChanged();
+}
 
-	red   = red * 255 / 63;
-	green = green * 255 / 63;
-	blue  = blue * 255 / 63;
+/*
+======================
+=
+= FadeProgress
+=
+= How many of steps have passed since starttime, at one step a VBL.  A
+= fade with nothing to show is done at once.
+=
+======================
+*/
+
+static int FadeProgress(Uint32 starttime, int steps)
+{
+	Uint32 done;
 
-	for (i = 0; i < steps; i++)
-	{
-		for (j = start; j <= end; j++)
-		{
-			int orig_r = origpal[j * 3 + 0] * 255 / 63;
-			int orig_g = origpal[j * 3 + 1] * 255 / 63;
-			int orig_b = origpal[j * 3 + 2] * 255 / 63;
+	if (vl_headless)
+		return steps;
 
-			sdl_palette[j].r = orig_r + (red - orig_r) * (i + 1) / steps;
-			sdl_palette[j].g = orig_g + (green - orig_g) * (i + 1) / steps;
-			sdl_palette[j].b = orig_b + (blue - orig_b) * (i + 1) / steps;
-		}
-		UpdateRGBAPalette();
-		VL_Present();
-		VL_WaitVBL(1);
+	done = (SDL_GetTicks() - starttime) * 70 / 1000 + 1;
+	return done < (Uint32)steps ? (int)done : steps;
+}
+
+/*
+======================
+=
+= FadeWait
+=
+= Sleeps until FadeProgress gets past step, so a fade presents once a
+= step instead of spinning on the same palette
+=
+======================
+*/
+
+static void FadeWait(Uint32 starttime, int step)
+{
+	Sint32 wait;
+
+	wait = (Sint32)(starttime + (step * 1000 + 69) / 70 - SDL_GetTicks());
+	if (wait > 0)
+		SDL_Delay(wait);
+}
+
+/*
+======================
+=
+= VL_FadeOutBegin
+= VL_FadeInBegin
+= VL_FadeFrame
+=
+= A fade timed like FizzleFrame's dissolve: each VL_FadeFrame sets colors
+= start to end as far from where they were to where they're going as the
+= time since the fade began calls for, so it can run under a live screen
+= that goes on being drawn.  VL_FadeFrame returns false once the fade is
+= done.  VL_SetPalette cuts a fade short.
+=
+======================
+*/
+
+boolean fading;                    // VL_FadeFrame has steps left to show
+
+static SDL_Color fadefrom[256], fadeto[256];
+static int       fadestart, fadeend, fadesteps, fadestep;
+static Uint32    fadestarttime;
+static byte      *fadepalette;     // what a fade in ends on, NULL fading out
+
+static void FadeBegin(int start, int end, int steps)
+{
+	memcpy(fadefrom, sdl_palette, sizeof(fadefrom));
+	vl_shift = NULL;
+
+	fadestart = start;
+	fadeend = end;
+	fadesteps = steps < 1 ? 1 : steps;
+	fadestep = 0;
+	fadestarttime = SDL_GetTicks();
+	fading = true;
+}
+
+void VL_FadeOutBegin(int start, int end, int red, int green, int blue, int steps)
+{
+	int i;
+
+	for (i = start; i <= end; i++)
+	{
+		fadeto[i].r = red * 255 / 63;
+		fadeto[i].g = green * 255 / 63;
+		fadeto[i].b = blue * 255 / 63;
 	}
+	fadepalette = NULL;
+	FadeBegin(start, end, steps);
+}
 
-	screenfaded = true;
+void VL_FadeInBegin(int start, int end, byte *palette, int steps)
+{
+	int i;
+
+	for (i = start; i <= end; i++)
+	{
+		fadeto[i].r = palette[i * 3 + 0] * 255 / 63;
+		fadeto[i].g = palette[i * 3 + 1] * 255 / 63;
+		fadeto[i].b = palette[i * 3 + 2] * 255 / 63;
+	}
+	fadepalette = palette;
+	FadeBegin(start, end, steps);
 }
 
-void VL_FadeIn(int start, int end, byte *palette, int steps)
+boolean VL_FadeFrame(void)
 {
-	int i, j;
-	SDL_Color origpal[256];
+	int j, step;
+
+	if (!fading)
+		return false;
 
-	// Save starting palette so we interpolate from fixed values
-	memcpy(origpal, sdl_palette, sizeof(origpal));
+	step = FadeProgress(fadestarttime, fadesteps);
+	if (step == fadestep)
+		return true;
+	fadestep = step;
 
-	for (i = 0; i < steps; i++)
+	for (j = fadestart; j <= fadeend; j++)
 	{
-		for (j = start; j <= end; j++)
-		{
-			int target_r = palette[j * 3 + 0] * 255 / 63;
-			int target_g = palette[j * 3 + 1] * 255 / 63;
-			int target_b = palette[j * 3 + 2] * 255 / 63;
+		sdl_palette[j].r = fadefrom[j].r + (fadeto[j].r - fadefrom[j].r) * step / fadesteps;
+		sdl_palette[j].g = fadefrom[j].g + (fadeto[j].g - fadefrom[j].g) * step / fadesteps;
+		sdl_palette[j].b = fadefrom[j].b + (fadeto[j].b - fadefrom[j].b) * step / fadesteps;
+	}
+	PaletteChanged();
 
-			sdl_palette[j].r = origpal[j].r + (target_r - origpal[j].r) * (i + 1) / steps;
-			sdl_palette[j].g = origpal[j].g + (target_g - origpal[j].g) * (i + 1) / steps;
-			sdl_palette[j].b = origpal[j].b + (target_b - origpal[j].b) * (i + 1) / steps;
-		}
-		UpdateRGBAPalette();
+	if (step < fadesteps)
+		return true;
+
+	fading = false;
+	if (fadepalette)
+		VL_SetPalette(fadepalette);    // exactly, and not faded any more
+	else
+		screenfaded = true;
+	return false;
+}
+
+/*
+======================
+=
+= VL_FadeOut
+= VL_FadeIn
+=
+= The old blocking fades for a still screen: a fade run a step at a time,
+= presenting each
+=
+======================
+*/
+
+static void FadeFrames(void)
+{
+	while (fading)
+	{
+		VL_FadeFrame();
 		VL_Present();
-		VL_WaitVBL(1);
+		VL_WaitPresent();
+		if (fading)
+			FadeWait(fadestarttime, fadestep);
 	}
+}
 
-	VL_SetPalette(palette);
-	screenfaded = false;
+void VL_FadeOut(int start, int end, int red, int green, int blue, int steps)
+{
+	VL_FadeOutBegin(start, end, red, green, blue, steps);
+	FadeFrames();
+}
+
+void VL_FadeIn(int start, int end, byte *palette, int steps)
+{
+	VL_FadeInBegin(start, end, palette, steps);
+	FadeFrames();
 }
 
 void VL_ColorBorder(int color)
@@ -18,6 +18,7 @@ extern unsigned ylookup[MAXSCANLINES];
 
 extern boolean  screenfaded;
 extern unsigned bordercolor;
+extern boolean  fading;          // VL_FadeFrame has steps left to show
 
 //===========================================================================
 
@@ -41,6 +42,10 @@ void VL_SetPalette(byte *palette);
 void VL_GetPalette(byte *palette);
 void VL_FadeOut(int start, int end, int red, int green, int blue, int steps);
 void VL_FadeIn(int start, int end, byte *palette, int steps);
+void VL_FadeOutBegin(int start, int end, int red, int green, int blue, int steps);
+void VL_FadeInBegin(int start, int end, byte *palette, int steps);
+boolean VL_FadeFrame(void);
+void VL_SetShift(byte *palette);
 void VL_ColorBorder(int color);
 
 void VL_Plot(int x, int y, int color);
@@ -64,9 +69,14 @@ void VL_TestPaletteSet(void);
 extern SDL_Window   *sdl_window;
 extern SDL_Renderer *sdl_renderer;
 extern SDL_Texture  *sdl_texture;
-extern byte         *sdl_framebuffer;   // 320x200 indexed color buffer
+extern byte         *sdl_framebuffer;   // 320x200 indexed, moves on VL_Present
+extern boolean      vl_headless;        // no window, set before VL_Startup
+extern boolean      vl_surfacepresent;  // no renderer, set before VL_Startup
 
 void VL_Present(void);
+void VL_ShowFrame(void);
+void VL_ForcePresent(void);
+void VL_WaitPresent(void);
 
 // Latch memory (for id_vh.c)
 extern byte *vl_latchmem;
@@ -12,9 +12,6 @@
 */
 
 
-statobj_t	statobjlist[MAXSTATS],*laststatobj;
-
-
 struct
 {
 	int		picnum;
@@ -269,15 +266,7 @@ Every time a door opens or closes the areabyplayer matrix gets recalculated.
 #define DOORWIDTH	0x7800
 #define OPENTICS	300
 
-doorobj_t	doorobjlist[MAXDOORS],*lastdoorobj;
-int			doornum;
-
-unsigned	doorposition[MAXDOORS];		// leading edge of door 0=closed
-										// 0xffff = fully open
-
-byte		far areaconnect[NUMAREAS][NUMAREAS];
-
-boolean		areabyplayer[NUMAREAS];
+#define doornum		(gameinst->doornum)	// other modules use doornum locals
 
 
 /*
@@ -417,7 +406,7 @@ void OpenDoor (int door)
 void CloseDoor (int door)
 {
 	int	tilex,tiley,area;
-	objtype *check;
+	word	check;
 
 //
 // don't close on anything solid
@@ -428,39 +417,39 @@ void CloseDoor (int door)
 	if (actorat[tilex][tiley])
 		return;
 
-	if (player->tilex == tilex && player->tiley == tiley)
+	if (HOT(player)->tilex == tilex && HOT(player)->tiley == tiley)
 		return;
 
 	if (doorobjlist[door].vertical)
 	{
-		if ( player->tiley == tiley )
+		if ( HOT(player)->tiley == tiley )
 		{
-			if ( ((player->x+MINDIST) >>TILESHIFT) == tilex )
+			if ( ((HOT(player)->x+MINDIST) >>TILESHIFT) == tilex )
 				return;
-			if ( ((player->x-MINDIST) >>TILESHIFT) == tilex )
+			if ( ((HOT(player)->x-MINDIST) >>TILESHIFT) == tilex )
 				return;
 		}
 		check = actorat[tilex-1][tiley];
-		if (check && ((check->x+MINDIST) >> TILESHIFT) == tilex )
+		if (ISACTOR(check) && ((HOT(HANDLEACTOR(check))->x+MINDIST) >> TILESHIFT) == tilex )
 			return;
 		check = actorat[tilex+1][tiley];
-		if (check && ((check->x-MINDIST) >> TILESHIFT) == tilex )
+		if (ISACTOR(check) && ((HOT(HANDLEACTOR(check))->x-MINDIST) >> TILESHIFT) == tilex )
 			return;
 	}
 	else if (!doorobjlist[door].vertical)
 	{
-		if (player->tilex == tilex)
+		if (HOT(player)->tilex == tilex)
 		{
-			if ( ((player->y+MINDIST) >>TILESHIFT) == tiley )
+			if ( ((HOT(player)->y+MINDIST) >>TILESHIFT) == tiley )
 				return;
-			if ( ((player->y-MINDIST) >>TILESHIFT) == tiley )
+			if ( ((HOT(player)->y-MINDIST) >>TILESHIFT) == tiley )
 				return;
 		}
 		check = actorat[tilex][tiley-1];
-		if (check && ((check->y+MINDIST) >> TILESHIFT) == tiley )
+		if (ISACTOR(check) && ((HOT(HANDLEACTOR(check))->y+MINDIST) >> TILESHIFT) == tiley )
 			return;
 		check = actorat[tilex][tiley+1];
-		if (check && ((check->y-MINDIST) >> TILESHIFT) == tiley )
+		if (ISACTOR(check) && ((HOT(HANDLEACTOR(check))->y-MINDIST) >> TILESHIFT) == tiley )
 			return;
 	}
 
@@ -624,7 +613,7 @@ void DoorClosing (int door)
 	tiley = doorobjlist[door].tiley;
 
 	if ( (ACTORAT_TO_INT(actorat[tilex][tiley]) != (door | 0x80))
-	|| (player->tilex == tilex && player->tiley == tiley) )
+	|| (HOT(player)->tilex == tilex && HOT(player)->tiley == tiley) )
 	{			// something got inside the door
 		OpenDoor (door);
 		return;
@@ -715,11 +704,6 @@ void MoveDoors (void)
 =============================================================================
 */
 
-unsigned	pwallstate;
-unsigned	pwallpos;			// amount a pushable wall has been moved (0-63)
-unsigned	pwallx,pwally;
-int			pwalldir;
-
 /*
 ===============
 =
@@ -238,13 +238,13 @@ void A_Smoke (objtype *ob)
 		new->state = &s_hsmoke1;
 	else
 #endif
-		new->state = &s_smoke1;
-	new->ticcount = 6;
+		HOT(new)->state = &s_smoke1;
+	HOT(new)->ticcount = 6;
 
-	new->tilex = ob->tilex;
-	new->tiley = ob->tiley;
-	new->x = ob->x;
-	new->y = ob->y;
+	HOT(new)->tilex = HOT(ob)->tilex;
+	HOT(new)->tiley = HOT(ob)->tiley;
+	HOT(new)->x = HOT(ob)->x;
+	HOT(new)->y = HOT(ob)->y;
 	new->obclass = inertobj;
 	new->active = true;
 
@@ -266,14 +266,14 @@ void A_Smoke (objtype *ob)
 boolean ProjectileTryMove (objtype *ob)
 {
 	int			xl,yl,xh,yh,x,y;
-	objtype		*check;
+	word		check;
 	long		deltax,deltay;
 
-	xl = (ob->x-PROJSIZE) >>TILESHIFT;
-	yl = (ob->y-PROJSIZE) >>TILESHIFT;
+	xl = (HOT(ob)->x-PROJSIZE) >>TILESHIFT;
+	yl = (HOT(ob)->y-PROJSIZE) >>TILESHIFT;
 
-	xh = (ob->x+PROJSIZE) >>TILESHIFT;
-	yh = (ob->y+PROJSIZE) >>TILESHIFT;
+	xh = (HOT(ob)->x+PROJSIZE) >>TILESHIFT;
+	yh = (HOT(ob)->y+PROJSIZE) >>TILESHIFT;
 
 //
 // check for solid walls
@@ -282,7 +282,7 @@ boolean ProjectileTryMove (objtype *ob)
 		for (x=xl;x<=xh;x++)
 		{
 			check = actorat[x][y];
-			if (check && check<objlist)
+			if (check && !ISACTOR(check))
 				return false;
 		}
 
@@ -315,18 +315,18 @@ void T_Projectile (objtype *ob)
 	if (deltay>0x10000l)
 		deltay = 0x10000l;
 
-	ob->x += deltax;
-	ob->y += deltay;
+	HOT(ob)->x += deltax;
+	HOT(ob)->y += deltay;
 
-	deltax = LABS(ob->x - player->x);
-	deltay = LABS(ob->y - player->y);
+	deltax = LABS(HOT(ob)->x - HOT(player)->x);
+	deltay = LABS(HOT(ob)->y - HOT(player)->y);
 
 	if (!ProjectileTryMove (ob))
 	{
 		if (ob->obclass == rocketobj)
 		{
 			PlaySoundLocActor(MISSILEHITSND,ob);
-			ob->state = &s_boom1;
+			HOT(ob)->state = &s_boom1;
 		}
 #ifdef SPEAR
 		else if (ob->obclass == hrocketobj)
@@ -336,7 +336,7 @@ void T_Projectile (objtype *ob)
 		}
 #endif
 		else
-			ob->state = NULL;		// mark for removal
+			HOT(ob)->state = NULL;		// mark for removal
 
 		return;
 	}
@@ -359,12 +359,12 @@ void T_Projectile (objtype *ob)
 		}
 
 		TakeDamage (damage,ob);
-		ob->state = NULL;		// mark for removal
+		HOT(ob)->state = NULL;		// mark for removal
 		return;
 	}
 
-	ob->tilex = ob->x >> TILESHIFT;
-	ob->tiley = ob->y >> TILESHIFT;
+	HOT(ob)->tilex = HOT(ob)->x >> TILESHIFT;
+	HOT(ob)->tiley = HOT(ob)->y >> TILESHIFT;
 
 }
 
@@ -1027,25 +1027,25 @@ void SpawnPatrol (enemy_t which, int tilex, int tiley, int dir)
 	new->flags |= FL_SHOOTABLE;
 	new->active = true;
 
-	actorat[new->tilex][new->tiley] = NULL;		// don't use original spot
+	actorat[HOT(new)->tilex][HOT(new)->tiley] = 0;		// don't use original spot
 
 	switch (dir)
 	{
 	case 0:
-		new->tilex++;
+		HOT(new)->tilex++;
 		break;
 	case 1:
-		new->tiley--;
+		HOT(new)->tiley--;
 		break;
 	case 2:
-		new->tilex--;
+		HOT(new)->tilex--;
 		break;
 	case 3:
-		new->tiley++;
+		HOT(new)->tiley++;
 		break;
 	}
 
-	actorat[new->tilex][new->tiley] = new;
+	actorat[HOT(new)->tilex][HOT(new)->tiley] = ACTORHANDLE(new);
 }
 
 
@@ -1062,9 +1062,9 @@ void A_DeathScream (objtype *ob)
 {
 #ifndef UPLOAD
 #ifndef SPEAR
-	if (mapon==9 && !US_RndT())
+	if (gamestate.mapon==9 && !US_RndT())
 #else
-	if ((mapon==18 || mapon==19) && !US_RndT())
+	if ((gamestate.mapon==18 || gamestate.mapon==19) && !US_RndT())
 #endif
 	{
 	 switch(ob->obclass)
@@ -1961,7 +1961,7 @@ moveok:
 				continue;
 			if (tile<256)
 				return;
-			if (((objtype *)tile)->flags&FL_SHOOTABLE)
+			if (HANDLEACTOR(tile)->flags&FL_SHOOTABLE)
 				return;
 		}
 
@@ -2302,21 +2302,21 @@ void T_SchabbThrow (objtype *ob)
 	float	angle;
 	int		iangle;
 
-	deltax = player->x - ob->x;
-	deltay = ob->y - player->y;
+	deltax = HOT(player)->x - HOT(ob)->x;
+	deltay = HOT(ob)->y - HOT(player)->y;
 	angle = atan2 (deltay,deltax);
 	if (angle<0)
 		angle = M_PI*2+angle;
 	iangle = angle/(M_PI*2)*ANGLES;
 
 	GetNewActor ();
-	new->state = &s_needle1;
-	new->ticcount = 1;
+	HOT(new)->state = &s_needle1;
+	HOT(new)->ticcount = 1;
 
-	new->tilex = ob->tilex;
-	new->tiley = ob->tiley;
-	new->x = ob->x;
-	new->y = ob->y;
+	HOT(new)->tilex = HOT(ob)->tilex;
+	HOT(new)->tiley = HOT(ob)->tiley;
+	HOT(new)->x = HOT(ob)->x;
+	HOT(new)->y = HOT(ob)->y;
 	new->obclass = needleobj;
 	new->dir = nodir;
 	new->angle = iangle;
@@ -2342,21 +2342,21 @@ void T_GiftThrow (objtype *ob)
 	float	angle;
 	int		iangle;
 
-	deltax = player->x - ob->x;
-	deltay = ob->y - player->y;
+	deltax = HOT(player)->x - HOT(ob)->x;
+	deltay = HOT(ob)->y - HOT(player)->y;
 	angle = atan2 (deltay,deltax);
 	if (angle<0)
 		angle = M_PI*2+angle;
 	iangle = angle/(M_PI*2)*ANGLES;
 
 	GetNewActor ();
-	new->state = &s_rocket;
-	new->ticcount = 1;
+	HOT(new)->state = &s_rocket;
+	HOT(new)->ticcount = 1;
 
-	new->tilex = ob->tilex;
-	new->tiley = ob->tiley;
-	new->x = ob->x;
-	new->y = ob->y;
+	HOT(new)->tilex = HOT(ob)->tilex;
+	HOT(new)->tiley = HOT(ob)->tiley;
+	HOT(new)->x = HOT(ob)->x;
+	HOT(new)->y = HOT(ob)->y;
 	new->obclass = rocketobj;
 	new->dir = nodir;
 	new->angle = iangle;
@@ -2384,8 +2384,8 @@ void T_Schabb (objtype *ob)
 	boolean	dodge;
 
 	dodge = false;
-	dx = abs(ob->tilex - player->tilex);
-	dy = abs(ob->tiley - player->tiley);
+	dx = abs(HOT(ob)->tilex - HOT(player)->tilex);
+	dy = abs(HOT(ob)->tiley - HOT(player)->tiley);
 	dist = dx>dy ? dx : dy;
 
 	if (CheckLine(ob))						// got a shot at player?
@@ -2440,8 +2440,8 @@ void T_Schabb (objtype *ob)
 		//
 		// fix position to account for round off during moving
 		//
-		ob->x = ((long)ob->tilex<<TILESHIFT)+TILEGLOBAL/2;
-		ob->y = ((long)ob->tiley<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->x = ((long)HOT(ob)->tilex<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->y = ((long)HOT(ob)->tiley<<TILESHIFT)+TILEGLOBAL/2;
 
 		move -= ob->distance;
 
@@ -2476,8 +2476,8 @@ void T_Gift (objtype *ob)
 	boolean	dodge;
 
 	dodge = false;
-	dx = abs(ob->tilex - player->tilex);
-	dy = abs(ob->tiley - player->tiley);
+	dx = abs(HOT(ob)->tilex - HOT(player)->tilex);
+	dy = abs(HOT(ob)->tiley - HOT(player)->tiley);
 	dist = dx>dy ? dx : dy;
 
 	if (CheckLine(ob))						// got a shot at player?
@@ -2532,8 +2532,8 @@ void T_Gift (objtype *ob)
 		//
 		// fix position to account for round off during moving
 		//
-		ob->x = ((long)ob->tilex<<TILESHIFT)+TILEGLOBAL/2;
-		ob->y = ((long)ob->tiley<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->x = ((long)HOT(ob)->tilex<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->y = ((long)HOT(ob)->tiley<<TILESHIFT)+TILEGLOBAL/2;
 
 		move -= ob->distance;
 
@@ -2568,8 +2568,8 @@ void T_Fat (objtype *ob)
 	boolean	dodge;
 
 	dodge = false;
-	dx = abs(ob->tilex - player->tilex);
-	dy = abs(ob->tiley - player->tiley);
+	dx = abs(HOT(ob)->tilex - HOT(player)->tilex);
+	dy = abs(HOT(ob)->tiley - HOT(player)->tiley);
 	dist = dx>dy ? dx : dy;
 
 	if (CheckLine(ob))						// got a shot at player?
@@ -2624,8 +2624,8 @@ void T_Fat (objtype *ob)
 		//
 		// fix position to account for round off during moving
 		//
-		ob->x = ((long)ob->tilex<<TILESHIFT)+TILEGLOBAL/2;
-		ob->y = ((long)ob->tiley<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->x = ((long)HOT(ob)->tilex<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->y = ((long)HOT(ob)->tiley<<TILESHIFT)+TILEGLOBAL/2;
 
 		move -= ob->distance;
 
@@ -2888,11 +2888,11 @@ void A_HitlerMorph (objtype *ob)
 	uint16_t *map; unsigned tile,hitpoints[4]={500,700,800,900};
 
 
-	SpawnNewObj (ob->tilex,ob->tiley,&s_hitlerchase1);
+	SpawnNewObj (HOT(ob)->tilex,HOT(ob)->tiley,&s_hitlerchase1);
 	new->speed = SPDPATROL*5;
 
-	new->x = ob->x;
-	new->y = ob->y;
+	HOT(new)->x = HOT(ob)->x;
+	HOT(new)->y = HOT(ob)->y;
 
 	new->distance = ob->distance;
 	new->dir = ob->dir;
@@ -2936,21 +2936,21 @@ void T_FakeFire (objtype *ob)
 	float	angle;
 	int		iangle;
 
-	deltax = player->x - ob->x;
-	deltay = ob->y - player->y;
+	deltax = HOT(player)->x - HOT(ob)->x;
+	deltay = HOT(ob)->y - HOT(player)->y;
 	angle = atan2 (deltay,deltax);
 	if (angle<0)
 		angle = M_PI*2+angle;
 	iangle = angle/(M_PI*2)*ANGLES;
 
 	GetNewActor ();
-	new->state = &s_fire1;
-	new->ticcount = 1;
+	HOT(new)->state = &s_fire1;
+	HOT(new)->ticcount = 1;
 
-	new->tilex = ob->tilex;
-	new->tiley = ob->tiley;
-	new->x = ob->x;
-	new->y = ob->y;
+	HOT(new)->tilex = HOT(ob)->tilex;
+	HOT(new)->tiley = HOT(ob)->tiley;
+	HOT(new)->x = HOT(ob)->x;
+	HOT(new)->y = HOT(ob)->y;
 	new->dir = nodir;
 	new->angle = iangle;
 	new->obclass = fireobj;
@@ -3013,8 +3013,8 @@ void T_Fake (objtype *ob)
 		//
 		// fix position to account for round off during moving
 		//
-		ob->x = ((long)ob->tilex<<TILESHIFT)+TILEGLOBAL/2;
-		ob->y = ((long)ob->tiley<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->x = ((long)HOT(ob)->tilex<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->y = ((long)HOT(ob)->tiley<<TILESHIFT)+TILEGLOBAL/2;
 
 		move -= ob->distance;
 
@@ -3078,8 +3078,8 @@ void T_Chase (objtype *ob)
 	dodge = false;
 	if (CheckLine(ob))	// got a shot at player?
 	{
-		dx = abs(ob->tilex - player->tilex);
-		dy = abs(ob->tiley - player->tiley);
+		dx = abs(HOT(ob)->tilex - HOT(player)->tilex);
+		dy = abs(HOT(ob)->tiley - HOT(player)->tiley);
 		dist = dx>dy ? dx : dy;
 		if (!dist || (dist==1 && ob->distance<0x4000) )
 			chance = 300;
@@ -3179,8 +3179,8 @@ void T_Chase (objtype *ob)
 		//
 		// fix position to account for round off during moving
 		//
-		ob->x = ((long)ob->tilex<<TILESHIFT)+TILEGLOBAL/2;
-		ob->y = ((long)ob->tiley<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->x = ((long)HOT(ob)->tilex<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->y = ((long)HOT(ob)->tiley<<TILESHIFT)+TILEGLOBAL/2;
 
 		move -= ob->distance;
 
@@ -3233,8 +3233,8 @@ void T_Ghosts (objtype *ob)
 		//
 		// fix position to account for round off during moving
 		//
-		ob->x = ((long)ob->tilex<<TILESHIFT)+TILEGLOBAL/2;
-		ob->y = ((long)ob->tiley<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->x = ((long)HOT(ob)->tilex<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->y = ((long)HOT(ob)->tiley<<TILESHIFT)+TILEGLOBAL/2;
 
 		move -= ob->distance;
 
@@ -3275,13 +3275,13 @@ void T_DogChase (objtype *ob)
 	//
 	// check for byte range
 	//
-		dx = player->x - ob->x;
+		dx = HOT(player)->x - HOT(ob)->x;
 		if (dx<0)
 			dx = -dx;
 		dx -= move;
 		if (dx <= MINACTORDIST)
 		{
-			dy = player->y - ob->y;
+			dy = HOT(player)->y - HOT(ob)->y;
 			if (dy<0)
 				dy = -dy;
 			dy -= move;
@@ -3305,8 +3305,8 @@ void T_DogChase (objtype *ob)
 		//
 		// fix position to account for round off during moving
 		//
-		ob->x = ((long)ob->tilex<<TILESHIFT)+TILEGLOBAL/2;
-		ob->y = ((long)ob->tiley<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->x = ((long)HOT(ob)->tilex<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->y = ((long)HOT(ob)->tiley<<TILESHIFT)+TILEGLOBAL/2;
 
 		move -= ob->distance;
 
@@ -3341,7 +3341,7 @@ void SelectPathDir (objtype *ob)
 {
 	unsigned spot;
 
-	spot = MAPSPOT(ob->tilex,ob->tiley,1)-ICONARROWS;
+	spot = MAPSPOT(HOT(ob)->tilex,HOT(ob)->tiley,1)-ICONARROWS;
 
 	if (spot<8)
 	{
@@ -3401,17 +3401,17 @@ void T_Path (objtype *ob)
 			break;
 		}
 
-		if (ob->tilex>MAPSIZE || ob->tiley>MAPSIZE)
+		if (HOT(ob)->tilex>MAPSIZE || HOT(ob)->tiley>MAPSIZE)
 		{
 			sprintf (str,"T_Path hit a wall at %u,%u, dir %u"
-			,ob->tilex,ob->tiley,ob->dir);
+			,HOT(ob)->tilex,HOT(ob)->tiley,ob->dir);
 			Quit (str);
 		}
 
 
 
-		ob->x = ((long)ob->tilex<<TILESHIFT)+TILEGLOBAL/2;
-		ob->y = ((long)ob->tiley<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->x = ((long)HOT(ob)->tilex<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->y = ((long)HOT(ob)->tiley<<TILESHIFT)+TILEGLOBAL/2;
 		move -= ob->distance;
 
 		SelectPathDir (ob);
@@ -3454,8 +3454,8 @@ void T_Shoot (objtype *ob)
 	if (!CheckLine (ob))			// player is behind a wall
 	  return;
 
-	dx = abs(ob->tilex - player->tilex);
-	dy = abs(ob->tiley - player->tiley);
+	dx = abs(HOT(ob)->tilex - HOT(player)->tilex);
+	dy = abs(HOT(ob)->tiley - HOT(player)->tiley);
 	dist = dx>dy ? dx:dy;
 
 	if (ob->obclass == ssobj || ob->obclass == bossobj)
@@ -3535,13 +3535,13 @@ void T_Bite (objtype *ob)
 
 	PlaySoundLocActor(DOGATTACKSND,ob);	// JAB
 
-	dx = player->x - ob->x;
+	dx = HOT(player)->x - HOT(ob)->x;
 	if (dx<0)
 		dx = -dx;
 	dx -= TILEGLOBAL;
 	if (dx <= MINACTORDIST)
 	{
-		dy = player->y - ob->y;
+		dy = HOT(player)->y - HOT(ob)->y;
 		if (dy<0)
 			dy = -dy;
 		dy -= TILEGLOBAL;
@@ -3622,9 +3622,9 @@ void SpawnBJVictory (void)
 {
 	uint16_t *map; unsigned tile;
 
-	SpawnNewObj (player->tilex,player->tiley+1,&s_bjrun1);
-	new->x = player->x;
-	new->y = player->y;
+	SpawnNewObj (HOT(player)->tilex,HOT(player)->tiley+1,&s_bjrun1);
+	HOT(new)->x = HOT(player)->x;
+	HOT(new)->y = HOT(player)->y;
 	new->obclass = bjobj;
 	new->dir = north;
 	new->temp1 = 6;			// tiles to run forward
@@ -3655,8 +3655,8 @@ void T_BJRun (objtype *ob)
 		}
 
 
-		ob->x = ((long)ob->tilex<<TILESHIFT)+TILEGLOBAL/2;
-		ob->y = ((long)ob->tiley<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->x = ((long)HOT(ob)->tilex<<TILESHIFT)+TILEGLOBAL/2;
+		HOT(ob)->y = ((long)HOT(ob)->tiley<<TILESHIFT)+TILEGLOBAL/2;
 		move -= ob->distance;
 
 		SelectPathDir (ob);
@@ -3731,13 +3731,13 @@ void T_BJDone (objtype *ob)
 boolean	CheckPosition (objtype *ob)
 {
 	int	x,y,xl,yl,xh,yh;
-	objtype *check;
+	word	check;
 
-	xl = (ob->x-PLAYERSIZE) >>TILESHIFT;
-	yl = (ob->y-PLAYERSIZE) >>TILESHIFT;
+	xl = (HOT(ob)->x-PLAYERSIZE) >>TILESHIFT;
+	yl = (HOT(ob)->y-PLAYERSIZE) >>TILESHIFT;
 
-	xh = (ob->x+PLAYERSIZE) >>TILESHIFT;
-	yh = (ob->y+PLAYERSIZE) >>TILESHIFT;
+	xh = (HOT(ob)->x+PLAYERSIZE) >>TILESHIFT;
+	yh = (HOT(ob)->y+PLAYERSIZE) >>TILESHIFT;
 
 	//
 	// check for solid walls
@@ -3746,7 +3746,7 @@ boolean	CheckPosition (objtype *ob)
 		for (x=xl;x<=xh;x++)
 		{
 			check = actorat[x][y];
-			if (check && check<objlist)
+			if (check && !ISACTOR(check))
 				return false;
 		}
 
@@ -3772,7 +3772,8 @@ void	A_StartDeathCam (objtype *ob)
 
 	FinishPaletteShifts ();
 
-	VW_WaitVBL (100);
+	if (!simonly)
+		VW_WaitVBL (100);
 
 	if (gamestate.victoryflag)
 	{
@@ -3781,36 +3782,40 @@ void	A_StartDeathCam (objtype *ob)
 	}
 
 	gamestate.victoryflag = true;
-	VW_Bar (0,0,320,200-STATUSLINES,127);
-	FizzleFade(bufferofs,displayofs,320,200-STATUSLINES,70,false);
-
-	PM_UnlockMainMem ();
-	CA_UpLevel ();
-	CacheLump(LEVELEND_LUMP_START,LEVELEND_LUMP_END);
-	#ifdef JAPAN
-	#ifndef JAPDEMO
-	CA_CacheScreen(C_LETSSEEPIC);
-	#endif
-	#else
-	Write(0,7,STR_SEEAGAIN);
-	#endif
-	CA_DownLevel ();
-	PM_CheckMainMem ();
-
-	VW_UpdateScreen ();
-
-	IN_UserInput(300);
+
+	if (!simonly)						// instances share the one screen
+	{
+		VW_Bar (0,0,320,200-STATUSLINES,127);
+		FizzleFade(bufferofs,displayofs,320,200-STATUSLINES,70,false);
+
+		PM_UnlockMainMem ();
+		CA_UpLevel ();
+		CacheLump(LEVELEND_LUMP_START,LEVELEND_LUMP_END);
+		#ifdef JAPAN
+		#ifndef JAPDEMO
+		CA_CacheScreen(C_LETSSEEPIC);
+		#endif
+		#else
+		Write(0,7,STR_SEEAGAIN);
+		#endif
+		CA_DownLevel ();
+		PM_CheckMainMem ();
+
+		VW_UpdateScreen ();
+
+		IN_UserInput(300);
+	}
 
 //
 // line angle up exactly
 //
 	NewState (player,&s_deathcam);
 
-	player->x = gamestate.killx;
-	player->y = gamestate.killy;
+	HOT(player)->x = gamestate.killx;
+	HOT(player)->y = gamestate.killy;
 
-	dx = ob->x - player->x;
-	dy = player->y - ob->y;
+	dx = HOT(ob)->x - HOT(player)->x;
+	dy = HOT(player)->y - HOT(ob)->y;
 
 	fangle = atan2(dy,dx);			// returns -pi to pi
 	if (fangle<0)
@@ -3827,26 +3832,29 @@ void	A_StartDeathCam (objtype *ob)
 		xmove = FixedByFrac(dist,costable[player->angle]);
 		ymove = -FixedByFrac(dist,sintable[player->angle]);
 
-		player->x = ob->x - xmove;
-		player->y = ob->y - ymove;
+		HOT(player)->x = HOT(ob)->x - xmove;
+		HOT(player)->y = HOT(ob)->y - ymove;
 		dist += 0x1000;
 
 	} while (!CheckPosition (player));
-	plux = player->x >> UNSIGNEDSHIFT;			// scale to fit in unsigned
-	pluy = player->y >> UNSIGNEDSHIFT;
-	player->tilex = player->x >> TILESHIFT;		// scale to tile values
-	player->tiley = player->y >> TILESHIFT;
+	plux = HOT(player)->x >> UNSIGNEDSHIFT;			// scale to fit in unsigned
+	pluy = HOT(player)->y >> UNSIGNEDSHIFT;
+	HOT(player)->tilex = HOT(player)->x >> TILESHIFT;		// scale to tile values
+	HOT(player)->tiley = HOT(player)->y >> TILESHIFT;
 
 //
 // go back to the game
 //
-	temp = bufferofs;
-	for (i=0;i<3;i++)
+	if (!simonly)
 	{
-		bufferofs = screenloc[i];
-		DrawPlayBorder ();
+		temp = bufferofs;
+		for (i=0;i<3;i++)
+		{
+			bufferofs = screenloc[i];
+			DrawPlayBorder ();
+		}
+		bufferofs = temp;
 	}
-	bufferofs = temp;
 
 	fizzlein = true;
 	switch (ob->obclass)
@@ -31,17 +31,8 @@ extern void SpawnBJVictory(void);
 
 
 //
-// player state info
+// player state info is in the game instance (see WL_INST)
 //
-boolean		running;
-long		thrustspeed;
-
-unsigned	plux,pluy;			// player coordinates scaled to unsigned
-
-int			anglefrac;
-int			gotgatgun;	// JR
-
-objtype		*LastAttacker;
 
 /*
 =============================================================================
@@ -59,7 +50,8 @@ statetype s_player = {false,0,0,T_Player,NULL,NULL};
 statetype s_attack = {false,0,0,T_Attack,NULL,NULL};
 
 
-long	playerxmove,playerymove;
+#define playerxmove		(gameinst->playerxmove)
+#define playerymove		(gameinst->playerymove)
 
 struct atkinf
 {
@@ -156,8 +148,8 @@ void ControlMovement (objtype *ob)
 
 	thrustspeed = 0;
 
-	oldx = player->x;
-	oldy = player->y;
+	oldx = HOT(player)->x;
+	oldy = HOT(player)->y;
 
 //
 // side to side move
@@ -221,8 +213,8 @@ void ControlMovement (objtype *ob)
 //
 // calculate total move
 //
-	playerxmove = player->x - oldx;
-	playerymove = player->y - oldy;
+	playerxmove = HOT(player)->x - oldx;
+	playerymove = HOT(player)->y - oldy;
 }
 
 /*
@@ -246,6 +238,9 @@ void StatusDrawPic (unsigned x, unsigned y, unsigned picnum)
 {
 	unsigned	temp;
 
+	if (simonly)
+		return;				// instances share the one status bar
+
 	temp = bufferofs;
 	bufferofs = 0;
 
@@ -303,8 +298,6 @@ void DrawFace (void)
 
 #define FACETICS	70
 
-int	facecount;
-
 void	UpdateFace (void)
 {
 
@@ -778,8 +771,8 @@ void GetBonus (statobj_t *check)
 
 	case	bo_spear:
 		spearflag = true;
-		spearx = player->x;
-		speary = player->y;
+		spearx = HOT(player)->x;
+		speary = HOT(player)->y;
 		spearangle = player->angle;
 		playstate = ex_completed;
 	}
@@ -789,6 +782,55 @@ void GetBonus (statobj_t *check)
 }
 
 
+/*
+===================
+=
+= GrabBonuses
+=
+= Picks up the bonus items in reach, once a tic.  Reach is where the
+= refresh used to grab them: the item projected from the view point
+= (focallength behind the player) no nearer than MINDIST and less than a
+= tile deep and half a tile to either side.  That only takes in the open
+= tiles next to the player, so there is no need for the view to have
+= been traced to see it.
+=
+===================
+*/
+
+void GrabBonuses (void)
+{
+	statobj_t	*statptr;
+	fixed		vsin,vcos,vx,vy;
+	long		gx,gy,nx,ny;
+	int			tx,ty;
+
+	vsin = sintable[player->angle];
+	vcos = costable[player->angle];
+	vx = HOT(player)->x - FixedByFrac(focallength,vcos);
+	vy = HOT(player)->y + FixedByFrac(focallength,vsin);
+	tx = HOT(player)->tilex;
+	ty = HOT(player)->tiley;
+
+	for (statptr = &statobjlist[0] ; statptr !=laststatobj ; statptr++)
+	{
+		if (statptr->shapenum == -1 || !(statptr->flags & FL_BONUS))
+			continue;
+		if (statptr->tilex+1 < tx || statptr->tilex > tx+1
+			|| statptr->tiley+1 < ty || statptr->tiley > ty+1)
+			continue;
+
+		gx = ((long)statptr->tilex<<TILESHIFT)+0x8000-vx;
+		gy = ((long)statptr->tiley<<TILESHIFT)+0x8000-vy;
+		nx = FixedByFrac(gx,vcos)-FixedByFrac(gy,vsin)-0x2000;	// 0x2000 is size of object
+		ny = FixedByFrac(gy,vcos)+FixedByFrac(gx,vsin);
+
+		if (nx >= MINDIST && nx < TILEGLOBAL
+			&& ny > -TILEGLOBAL/2 && ny < TILEGLOBAL/2)
+			GetBonus (statptr);
+	}
+}
+
+
 /*
 ===================
 =
@@ -802,14 +844,15 @@ void GetBonus (statobj_t *check)
 boolean TryMove (objtype *ob)
 {
 	int			xl,yl,xh,yh,x,y;
-	objtype		*check;
+	word		check;
+	objtype		*checkob;
 	long		deltax,deltay;
 
-	xl = (ob->x-PLAYERSIZE) >>TILESHIFT;
-	yl = (ob->y-PLAYERSIZE) >>TILESHIFT;
+	xl = (HOT(ob)->x-PLAYERSIZE) >>TILESHIFT;
+	yl = (HOT(ob)->y-PLAYERSIZE) >>TILESHIFT;
 
-	xh = (ob->x+PLAYERSIZE) >>TILESHIFT;
-	yh = (ob->y+PLAYERSIZE) >>TILESHIFT;
+	xh = (HOT(ob)->x+PLAYERSIZE) >>TILESHIFT;
+	yh = (HOT(ob)->y+PLAYERSIZE) >>TILESHIFT;
 
 //
 // check for solid walls
@@ -818,7 +861,7 @@ boolean TryMove (objtype *ob)
 		for (x=xl;x<=xh;x++)
 		{
 			check = actorat[x][y];
-			if (check && check<objlist)
+			if (check && !ISACTOR(check))
 				return false;
 		}
 
@@ -838,13 +881,15 @@ boolean TryMove (objtype *ob)
 		for (x=xl;x<=xh;x++)
 		{
 			check = actorat[x][y];
-			if (check > objlist
-			&& (check->flags & FL_SHOOTABLE) )
+			if (!ISACTOR(check) || check == ACTORHANDLE(player))
+				continue;
+			checkob = HANDLEACTOR(check);
+			if (checkob->flags & FL_SHOOTABLE)
 			{
-				deltax = ob->x - check->x;
+				deltax = HOT(ob)->x - HOT(checkob)->x;
 				if (deltax < -MINACTORDIST || deltax > MINACTORDIST)
 					continue;
-				deltay = ob->y - check->y;
+				deltay = HOT(ob)->y - HOT(checkob)->y;
 				if (deltay < -MINACTORDIST || deltay > MINACTORDIST)
 					continue;
 
@@ -868,34 +913,34 @@ void ClipMove (objtype *ob, long xmove, long ymove)
 {
 	long	basex,basey;
 
-	basex = ob->x;
-	basey = ob->y;
+	basex = HOT(ob)->x;
+	basey = HOT(ob)->y;
 
-	ob->x = basex+xmove;
-	ob->y = basey+ymove;
+	HOT(ob)->x = basex+xmove;
+	HOT(ob)->y = basey+ymove;
 	if (TryMove (ob))
 		return;
 
-	if (noclip && ob->x > 2*TILEGLOBAL && ob->y > 2*TILEGLOBAL &&
-	ob->x < (((long)(mapwidth-1))<<TILESHIFT)
-	&& ob->y < (((long)(mapheight-1))<<TILESHIFT) )
+	if (noclip && HOT(ob)->x > 2*TILEGLOBAL && HOT(ob)->y > 2*TILEGLOBAL &&
+	HOT(ob)->x < (((long)(mapwidth-1))<<TILESHIFT)
+	&& HOT(ob)->y < (((long)(mapheight-1))<<TILESHIFT) )
 		return;		// walk through walls
 
 	if (!SD_SoundPlaying())
 		SD_PlaySound (HITWALLSND);
 
-	ob->x = basex+xmove;
-	ob->y = basey;
+	HOT(ob)->x = basex+xmove;
+	HOT(ob)->y = basey;
 	if (TryMove (ob))
 		return;
 
-	ob->x = basex;
-	ob->y = basey+ymove;
+	HOT(ob)->x = basex;
+	HOT(ob)->y = basey+ymove;
 	if (TryMove (ob))
 		return;
 
-	ob->x = basex;
-	ob->y = basey;
+	HOT(ob)->x = basex;
+	HOT(ob)->y = basey;
 }
 
 //==========================================================================
@@ -953,10 +998,10 @@ void Thrust (int angle, long speed)
 
 	ClipMove(player,xmove,ymove);
 
-	player->tilex = player->x >> TILESHIFT;		// scale to tile values
-	player->tiley = player->y >> TILESHIFT;
+	HOT(player)->tilex = HOT(player)->x >> TILESHIFT;		// scale to tile values
+	HOT(player)->tiley = HOT(player)->y >> TILESHIFT;
 
-	offset = farmapylookup[player->tiley]+player->tilex;
+	offset = farmapylookup[HOT(player)->tiley]+HOT(player)->tilex;
 	player->areanumber = *(mapsegs[0] + offset) -AREATILE;
 
 	if (*(mapsegs[1] + offset) == EXITTILE)
@@ -987,7 +1032,7 @@ void Cmd_Fire (void)
 
 	gamestate.weaponframe = 0;
 
-	player->state = &s_attack;
+	HOT(player)->state = &s_attack;
 
 	gamestate.attackframe = 0;
 	gamestate.attackcount =
@@ -1018,29 +1063,29 @@ void Cmd_Use (void)
 //
 	if (player->angle < ANGLES/8 || player->angle > 7*ANGLES/8)
 	{
-		checkx = player->tilex + 1;
-		checky = player->tiley;
+		checkx = HOT(player)->tilex + 1;
+		checky = HOT(player)->tiley;
 		dir = di_east;
 		elevatorok = true;
 	}
 	else if (player->angle < 3*ANGLES/8)
 	{
-		checkx = player->tilex;
-		checky = player->tiley-1;
+		checkx = HOT(player)->tilex;
+		checky = HOT(player)->tiley-1;
 		dir = di_north;
 		elevatorok = false;
 	}
 	else if (player->angle < 5*ANGLES/8)
 	{
-		checkx = player->tilex - 1;
-		checky = player->tiley;
+		checkx = HOT(player)->tilex - 1;
+		checky = HOT(player)->tiley;
 		dir = di_west;
 		elevatorok = true;
 	}
 	else
 	{
-		checkx = player->tilex;
-		checky = player->tiley + 1;
+		checkx = HOT(player)->tilex;
+		checky = HOT(player)->tiley + 1;
 		dir = di_south;
 		elevatorok = false;
 	}
@@ -1063,7 +1108,7 @@ void Cmd_Use (void)
 		buttonheld[bt_use] = true;
 
 		tilemap[checkx][checky]++;		// flip switch
-		if (*(mapsegs[0]+farmapylookup[player->tiley]+player->tilex) == ALTELEVATORTILE)
+		if (*(mapsegs[0]+farmapylookup[HOT(player)->tiley]+HOT(player)->tilex) == ALTELEVATORTILE)
 			playstate = ex_secretlevel;
 		else
 			playstate = ex_completed;
@@ -1102,13 +1147,13 @@ void SpawnPlayer (int tilex, int tiley, int dir)
 {
 	player->obclass = playerobj;
 	player->active = true;
-	player->tilex = tilex;
-	player->tiley = tiley;
+	HOT(player)->tilex = tilex;
+	HOT(player)->tiley = tiley;
 	player->areanumber =
-		*(mapsegs[0] + farmapylookup[player->tiley]+player->tilex);
-	player->x = ((long)tilex<<TILESHIFT)+TILEGLOBAL/2;
-	player->y = ((long)tiley<<TILESHIFT)+TILEGLOBAL/2;
-	player->state = &s_player;
+		*(mapsegs[0] + farmapylookup[HOT(player)->tiley]+HOT(player)->tilex);
+	HOT(player)->x = ((long)tilex<<TILESHIFT)+TILEGLOBAL/2;
+	HOT(player)->y = ((long)tiley<<TILESHIFT)+TILEGLOBAL/2;
+	HOT(player)->state = &s_player;
 	player->angle = (1-dir)*90;
 	if (player->angle<0)
 		player->angle += ANGLES;
@@ -1135,23 +1180,28 @@ void	KnifeAttack (objtype *ob)
 {
 	objtype *check,*closest;
 	long	dist;
+	int		i,slot;
 
 	SD_PlaySound (ATKKNIFESND);
 // actually fire
 	dist = 0x7fffffff;
 	closest = NULL;
-	for (check=ob->next ; check ; check=check->next)
+	for (i=1 ; i<objcount ; i++)
+	{
+		slot = objorder[i];
+		check = &objlist[slot];
 		if ( (check->flags & FL_SHOOTABLE)
 		&& (check->flags & FL_VISABLE)
-		&& abs (check->viewx-centerx) < shootdelta
+		&& abs (actviewx[slot]-centerx) < shootdelta
 		)
 		{
-			if (check->transx < dist)
+			if (acttransx[slot] < dist)
 			{
-				dist = check->transx;
+				dist = acttransx[slot];
 				closest = check;
 			}
 		}
+	}
 
 	if (!closest || dist> 0x18000l)
 	{
@@ -1172,6 +1222,7 @@ void	GunAttack (objtype *ob)
 	int		damage;
 	int		dx,dy,dist;
 	long	viewdist;
+	int		i,slot;
 
 	switch (gamestate.weapon)
 	{
@@ -1198,18 +1249,22 @@ void	GunAttack (objtype *ob)
 	{
 		oldclosest = closest;
 
-		for (check=ob->next ; check ; check=check->next)
+		for (i=1 ; i<objcount ; i++)
+		{
+			slot = objorder[i];
+			check = &objlist[slot];
 			if ( (check->flags & FL_SHOOTABLE)
 			&& (check->flags & FL_VISABLE)
-			&& abs (check->viewx-centerx) < shootdelta
+			&& abs (actviewx[slot]-centerx) < shootdelta
 			)
 			{
-				if (check->transx < viewdist)
+				if (acttransx[slot] < viewdist)
 				{
-					viewdist = check->transx;
+					viewdist = acttransx[slot];
 					closest = check;
 				}
 			}
+		}
 
 		if (closest == oldclosest)
 			return;						// no more targets, all missed
@@ -1225,8 +1280,8 @@ void	GunAttack (objtype *ob)
 //
 // hit something
 //
-	dx = abs(closest->tilex - player->tilex);
-	dy = abs(closest->tiley - player->tiley);
+	dx = abs(HOT(closest)->tilex - HOT(player)->tilex);
+	dy = abs(HOT(closest)->tiley - HOT(player)->tiley);
 	dist = dx>dy ? dx:dy;
 
 	if (dist<2)
@@ -1270,13 +1325,13 @@ void VictorySpin (void)
 			player->angle = 270;
 	}
 
-	desty = (((long)player->tiley-5)<<TILESHIFT)-0x3000;
+	desty = (((long)HOT(player)->tiley-5)<<TILESHIFT)-0x3000;
 
-	if (player->y > desty)
+	if (HOT(player)->y > desty)
 	{
-		player->y -= tics*4096;
-		if (player->y < desty)
-			player->y = desty;
+		HOT(player)->y -= tics*4096;
+		if (HOT(player)->y < desty)
+			HOT(player)->y = desty;
 	}
 }
 
@@ -1313,10 +1368,10 @@ void	T_Attack (objtype *ob)
 	if (gamestate.victoryflag)		// watching the BJ actor
 		return;
 
-	plux = player->x >> UNSIGNEDSHIFT;			// scale to fit in unsigned
-	pluy = player->y >> UNSIGNEDSHIFT;
-	player->tilex = player->x >> TILESHIFT;		// scale to tile values
-	player->tiley = player->y >> TILESHIFT;
+	plux = HOT(player)->x >> UNSIGNEDSHIFT;			// scale to fit in unsigned
+	pluy = HOT(player)->y >> UNSIGNEDSHIFT;
+	HOT(player)->tilex = HOT(player)->x >> TILESHIFT;		// scale to tile values
+	HOT(player)->tiley = HOT(player)->y >> TILESHIFT;
 
 //
 // change frame and fire
@@ -1328,7 +1383,7 @@ void	T_Attack (objtype *ob)
 		switch (cur->attack)
 		{
 		case -1:
-			ob->state = &s_player;
+			HOT(ob)->state = &s_player;
 			if (!gamestate.ammo)
 			{
 				gamestate.weapon = wp_knife;
@@ -1413,10 +1468,10 @@ void	T_Player (objtype *ob)
 		return;
 
 
-	plux = player->x >> UNSIGNEDSHIFT;			// scale to fit in unsigned
-	pluy = player->y >> UNSIGNEDSHIFT;
-	player->tilex = player->x >> TILESHIFT;		// scale to tile values
-	player->tiley = player->y >> TILESHIFT;
+	plux = HOT(player)->x >> UNSIGNEDSHIFT;			// scale to fit in unsigned
+	pluy = HOT(player)->y >> UNSIGNEDSHIFT;
+	HOT(player)->tilex = HOT(player)->x >> TILESHIFT;		// scale to tile values
+	HOT(player)->tiley = HOT(player)->y >> TILESHIFT;
 }
 
 
@@ -0,0 +1,341 @@
+// WL_BATCH.C
+
+#include "wl_def.h"
+#include "wl_lib.h"
+
+/*
+=============================================================================
+
+							BATCH STEPPING
+
+A batch steps a fixed set of instances together on a pool of threads.  The
+instances are dealt out in equal runs, one run per thread; a thread that
+finishes its own run takes instances off the front of the others', so one
+slow instance doesn't hold a whole run up.  The calling thread is worker 0.
+
+Observations go to one buffer the caller provides, W3D_BatchStride bytes
+for each instance: its w3d_status, then its frame.
+
+=============================================================================
+*/
+
+typedef struct
+{
+	SDL_Thread	*thread;
+	SDL_atomic_t	next;			// next instance of this run to step
+	int			end;
+} batchworker_t;
+
+struct w3d_batch_s
+{
+	w3d_instance	**inst;
+	int				count;
+
+	batchworker_t	*worker;
+	int				numworkers;
+
+	SDL_mutex		*lock;
+	SDL_cond		*start,*done;
+	int				generation;		// bumped for every W3D_StepBatch
+	int				busy;			// pool threads still stepping
+	boolean			quit;
+
+//
+// the step in progress
+//
+	const w3d_input	*inputs;
+	int				ntics,render;
+	unsigned char	*obs;
+	size_t			stride;
+	size_t			framesize;		// every instance's, checked each step
+
+	long			steps;			// instance steps, count a W3D_StepBatch
+	Uint64			counter;		// performance counter ticks stepping
+};
+
+
+/*
+===================
+=
+= StepInstance
+=
+===================
+*/
+
+static void StepInstance (w3d_batch *b, int i)
+{
+	w3d_status	*status;
+	const unsigned char	*frame;
+	int			width,height;
+
+	W3D_Step (b->inst[i],&b->inputs[i],b->ntics,b->render);
+
+	status = (w3d_status *)(b->obs+i*b->stride);
+	W3D_GetStatus (b->inst[i],status);
+
+	if (b->render)
+	{
+		if (W3D_FrameSize (b->inst[i]) != b->framesize)
+			Quit ("W3D_StepBatch: Frame size changed since W3D_CreateBatch!");
+		frame = W3D_Frame (b->inst[i],&width,&height);
+		memcpy ((byte *)status+sizeof(w3d_status),frame,b->framesize);
+	}
+}
+
+
+/*
+===================
+=
+= RunWorker
+=
+= Steps this worker's own run, then steals from the others
+=
+===================
+*/
+
+static void RunWorker (w3d_batch *b, int num)
+{
+	batchworker_t	*victim;
+	int				i,n;
+
+	for (n=0;n<b->numworkers;n++)
+	{
+		victim = &b->worker[(num+n)%b->numworkers];
+		while ((i = SDL_AtomicAdd (&victim->next,1)) < victim->end)
+			StepInstance (b,i);
+	}
+}
+
+
+/*
+===================
+=
+= PoolThread
+=
+===================
+*/
+
+typedef struct
+{
+	w3d_batch	*batch;
+	int			num;
+} poolstart_t;
+
+static int PoolThread (void *data)
+{
+	w3d_batch	*b;
+	int			num,seen;
+
+	b = ((poolstart_t *)data)->batch;
+	num = ((poolstart_t *)data)->num;
+	free (data);
+
+	seen = 0;
+	for (;;)
+	{
+		SDL_LockMutex (b->lock);
+		while (b->generation == seen && !b->quit)
+			SDL_CondWait (b->start,b->lock);
+		seen = b->generation;
+		if (b->quit)
+		{
+			SDL_UnlockMutex (b->lock);
+			return 0;
+		}
+		SDL_UnlockMutex (b->lock);
+
+		RunWorker (b,num);
+
+		SDL_LockMutex (b->lock);
+		if (!--b->busy)
+			SDL_CondSignal (b->done);
+		SDL_UnlockMutex (b->lock);
+	}
+}
+
+
+/*
+===================
+=
+= W3D_CreateBatch
+=
+= threads 0 uses one per CPU
+=
+===================
+*/
+
+w3d_batch *W3D_CreateBatch (w3d_instance **inst, int count, int threads)
+{
+	w3d_batch	*b;
+	poolstart_t	*ps;
+	int			i;
+
+	if (count < 1)
+		Quit ("W3D_CreateBatch: No instances!");
+
+	if (threads < 1)
+		threads = SDL_GetCPUCount ();
+	if (threads > count)
+		threads = count;
+	if (threads < 1)
+		threads = 1;
+
+	b = calloc (1,sizeof(*b));
+	if (!b)
+		Quit ("W3D_CreateBatch: Out of memory!");
+
+	b->inst = malloc (count*sizeof(*b->inst));
+	b->worker = calloc (threads,sizeof(*b->worker));
+	if (!b->inst || !b->worker)
+		Quit ("W3D_CreateBatch: Out of memory!");
+
+	memcpy (b->inst,inst,count*sizeof(*b->inst));
+	b->count = count;
+	b->numworkers = threads;
+
+	b->framesize = W3D_FrameSize (inst[0]);
+	b->stride = (sizeof(w3d_status)+b->framesize+7)&~(size_t)7;
+
+	for (i=0;i<count;i++)
+		if (W3D_FrameSize (inst[i]) != b->framesize)
+			Quit ("W3D_CreateBatch: Instances have different frame sizes!");
+
+	b->lock = SDL_CreateMutex ();
+	b->start = SDL_CreateCond ();
+	b->done = SDL_CreateCond ();
+	if (!b->lock || !b->start || !b->done)
+		Quit ("W3D_CreateBatch: Can't create lock!");
+
+	for (i=1;i<threads;i++)
+	{
+		ps = malloc (sizeof(*ps));
+		if (!ps)
+			Quit ("W3D_CreateBatch: Out of memory!");
+		ps->batch = b;
+		ps->num = i;
+		b->worker[i].thread = SDL_CreateThread (PoolThread,"w3dbatch",ps);
+		if (!b->worker[i].thread)
+			Quit ("W3D_CreateBatch: Can't create thread!");
+	}
+
+	return b;
+}
+
+
+/*
+===================
+=
+= W3D_DestroyBatch
+=
+= The instances are left alone
+=
+===================
+*/
+
+void W3D_DestroyBatch (w3d_batch *b)
+{
+	int		i;
+
+	if (!b)
+		return;
+
+	SDL_LockMutex (b->lock);
+	b->quit = true;
+	SDL_CondBroadcast (b->start);
+	SDL_UnlockMutex (b->lock);
+
+	for (i=1;i<b->numworkers;i++)
+		SDL_WaitThread (b->worker[i].thread,NULL);
+
+	SDL_DestroyCond (b->done);
+	SDL_DestroyCond (b->start);
+	SDL_DestroyMutex (b->lock);
+
+	free (b->worker);
+	free (b->inst);
+	free (b);
+}
+
+
+/*
+===================
+=
+= W3D_BatchStride
+=
+===================
+*/
+
+size_t W3D_BatchStride (w3d_batch *b)
+{
+	return b->stride;
+}
+
+
+/*
+===================
+=
+= W3D_StepBatch
+=
+===================
+*/
+
+int W3D_StepBatch (w3d_batch *b, const w3d_input *inputs, int ntics,
+	int render, unsigned char *obs)
+{
+	Uint64		starttime;
+	int			i,run,playing;
+
+	starttime = SDL_GetPerformanceCounter ();
+
+	b->inputs = inputs;
+	b->ntics = ntics;
+	b->render = render;
+	b->obs = obs;
+
+	run = (b->count+b->numworkers-1)/b->numworkers;
+	for (i=0;i<b->numworkers;i++)
+	{
+		SDL_AtomicSet (&b->worker[i].next,i*run);
+		b->worker[i].end = (i+1)*run < b->count ? (i+1)*run : b->count;
+	}
+
+	SDL_LockMutex (b->lock);
+	b->busy = b->numworkers-1;
+	b->generation++;
+	SDL_CondBroadcast (b->start);
+	SDL_UnlockMutex (b->lock);
+
+	RunWorker (b,0);
+
+	SDL_LockMutex (b->lock);
+	while (b->busy)
+		SDL_CondWait (b->done,b->lock);
+	SDL_UnlockMutex (b->lock);
+
+	b->steps += b->count;
+	b->counter += SDL_GetPerformanceCounter ()-starttime;
+
+	playing = 0;
+	for (i=0;i<b->count;i++)
+		if (((w3d_status *)(obs+i*b->stride))->state == W3D_PLAYING)
+			playing++;
+
+	return playing;
+}
+
+
+/*
+===================
+=
+= W3D_BatchRate
+=
+===================
+*/
+
+double W3D_BatchRate (w3d_batch *b)
+{
+	if (!b->counter)
+		return 0;
+
+	return (double)b->steps*SDL_GetPerformanceFrequency ()/b->counter;
+}
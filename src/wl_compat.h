@@ -6,6 +6,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <strings.h>
 #include <ctype.h>
@@ -159,12 +160,16 @@ extern char **_argv;
 #define O_TEXT 0
 #endif
 
-// Helper for storing integer values in pointer arrays (actorat pattern)
-// Wolf3D stores small integers and pointers in the same array
-#include <stdint.h>
-#define ACTORAT_INT(val) ((objtype *)(uintptr_t)(unsigned)(val))
-#define ACTORAT_IS_INT(ptr) ((uintptr_t)(ptr) < 256)
-#define ACTORAT_TO_INT(ptr) ((unsigned)(uintptr_t)(ptr))
+// Helpers for the tile codes stored in actorat (actorat pattern)
+// Wolf3D stores small integers and actors in the same array, the port
+// stores actors as handles (see ACTORHANDLE in wl_def.h)
+#define ACTORAT_INT(val) ((word)(val))
+#define ACTORAT_IS_INT(h) ((h) < 256)
+#define ACTORAT_TO_INT(h) ((unsigned)(h))
+
+// Per-thread storage, for render scratch that each game instance thread
+// needs its own copy of (see gameinst in wl_def.h)
+#define THREADLOCAL __thread
 
 // _fstrcpy/_fstrlen (Borland far string functions)
 #define _fstrcpy strcpy
@@ -104,10 +104,11 @@ void CountObjects (void)
 	US_PrintUnsigned (count);
 
 	US_Print ("\nDoors         :");
-	US_PrintUnsigned (doornum);
+	US_PrintUnsigned (gameinst->doornum);
 
-	for (obj=player->next;obj;obj=obj->next)
+	for (i=1;i<objcount;i++)
 	{
+		obj = ORDERACTOR(i);
 		if (obj->active)
 			active++;
 		else
@@ -413,9 +414,9 @@ int DebugKeys (void)
 	{
 		CenterWindow (14,4);
 		US_Print ("X:");
-		US_PrintUnsigned (player->x);
+		US_PrintUnsigned (HOT(player)->x);
 		US_Print ("\nY:");
-		US_PrintUnsigned (player->y);
+		US_PrintUnsigned (HOT(player)->y);
 		US_Print ("\nA:");
 		US_PrintUnsigned (player->angle);
 		VW_UpdateScreen();
@@ -647,32 +647,45 @@ typedef struct doorstruct
 //
 //--------------------
 
+//
+// the fields every actor pass reads are kept apart, in objhot[] by objlist
+// slot, so the passes stream through them; HOT(ob) is an actor's entry
+//
+typedef struct
+{
+	fixed 		x,y;
+	statetype	*state;
+	unsigned	tilex,tiley;
+	int			ticcount;
+} objhot_t;
+
 typedef struct objstruct
 {
 	activetype	active;
-	int			ticcount;
 	classtype	obclass;
-	statetype	*state;
 
 	byte		flags;				//	FL_SHOOTABLE, etc
 
 	long		distance;			// if negative, wait for that door to open
 	dirtype		dir;
 
-	fixed 		x,y;
-	unsigned	tilex,tiley;
 	byte		areanumber;
 
-	int	 		viewx;
-	unsigned	viewheight;
-	fixed		transx,transy;		// in global coord
-
 	int 		angle;
 	int			hitpoints;
 	long		speed;
 
 	int			temp1,temp2,temp3;
-	struct		objstruct	*next,*prev;
+
+//
+// scheduler bookkeeping, not saved (see DoActors)
+//
+	long		seq;				// spawn order, actors think in this order
+	long		wakeup;				// actortic a parked countdown runs out
+	byte		parked;				// only counting down / marking itself
+	byte		schedlist;			// sl_ list the actor is filed on
+	byte		schedarea;			// areaactors[] list when sl_area
+	struct		objstruct	*schednext,*schedprev;
 } objtype;
 
 
@@ -748,6 +761,190 @@ typedef	enum	{
 } exit_t;
 
 
+//---------------
+//
+// actor scheduler list, see DoActors
+//
+//---------------
+
+#define WHEELSIZE	128				// power of two, longer countdowns lap it
+
+typedef struct
+{
+	objtype	*head,*tail;
+} actorlist_t;
+
+
+/*
+=============================================================================
+
+						 WL_INST DEFINITIONS
+
+=============================================================================
+*/
+
+//
+// Everything a game in progress changes lives in a gameinst_t, so several
+// games can run in one process.  gameinst is the instance the calling
+// thread is running; the names below stand for its fields, so the game
+// code reads the same as it always has.  Per frame raycaster scratch that
+// doesn't outlive a refresh is THREADLOCAL instead (see WL_DRAW).
+//
+typedef struct gameinst_s
+{
+//
+// WL_GAME
+//
+	gametype	gamestate;
+	boolean		fizzlein;
+	long		spearx,speary;
+	unsigned	spearangle;
+	boolean		spearflag;
+
+//
+// WL_PLAY
+//
+	exit_t		playstate;
+	boolean		madenoise;					// true when shooting or screaming
+
+	objtype		objlist[MAXACTORS],*new,*player,*killerobj;
+	objhot_t	objhot[MAXACTORS];
+	byte		objorder[MAXACTORS];		// live objlist slots in spawn order
+	int			objcount;
+	byte		objfree[MAXACTORS];
+	int			numobjfree;
+
+	long		actortic;				// tics of actor thinking this level
+	long		actorseq;
+	actorlist_t	pendingactors,runactors,idleactors;
+	actorlist_t	areaactors[NUMAREAS];
+	actorlist_t	actorwheel[WHEELSIZE];
+	objtype		*tickorder[MAXACTORS];
+	int			numticking,tickpos;
+	boolean		inactorpass;
+
+	byte		tilemap[MAPSIZE][MAPSIZE];	// wall values only
+	byte		spotvis[MAPSIZE][MAPSIZE];
+	word		actorat[MAPSIZE][MAPSIZE];
+	word		mapsegs[MAPPLANES][MAPSIZE*MAPSIZE];	// private copy, pushwalls edit it
+
+	int			controlx,controly;		// range from -100 to 100 per tic
+	boolean		buttonstate[NUMBUTTONS],buttonheld[NUMBUTTONS];
+
+	int			damagecount,bonuscount;
+	boolean		palshifted;
+	int			palshift;			// see PaletteShift
+	long		funnyticount;		// FOR FUNNY BJ FACE
+
+//
+// WL_ACT1
+//
+	statobj_t	statobjlist[MAXSTATS],*laststatobj;
+	doorobj_t	doorobjlist[MAXDOORS],*lastdoorobj;
+	int			doornum;
+	unsigned	doorposition[MAXDOORS];		// leading edge of door 0=closed
+											// 0xffff = fully open
+	byte		areaconnect[NUMAREAS][NUMAREAS];
+	boolean		areabyplayer[NUMAREAS];
+	unsigned	pwallstate;
+	unsigned	pwallpos;			// amount a pushable wall has been moved (0-63)
+	unsigned	pwallx,pwally;
+	int			pwalldir;
+
+//
+// WL_AGENT
+//
+	boolean		running;
+	long		thrustspeed;
+	unsigned	plux,pluy;			// player coordinates scaled to unsigned
+	int			anglefrac,facecount,gotgatgun;
+	objtype		*LastAttacker;
+	long		playerxmove,playerymove;
+
+//
+// WL_DRAW
+//
+	long		lasttimecount,frameon;
+	int			actviewx[MAXACTORS];
+	unsigned	actviewheight[MAXACTORS];
+	fixed		acttransx[MAXACTORS],acttransy[MAXACTORS];
+
+//
+// ID_US_1
+//
+	int			rndindex;
+} gameinst_t;
+
+extern	THREADLOCAL gameinst_t	*gameinst;
+
+gameinst_t	*GI_NewInstance (void);
+void		GI_FreeInstance (gameinst_t *gi);
+void		GI_SetInstance (gameinst_t *gi);
+
+#define GI_SNAPSHOTSIZE	sizeof(gameinst_t)
+
+void		GI_Snapshot (gameinst_t *gi, void *buffer);
+void		GI_Restore (gameinst_t *gi, const void *buffer);
+
+#define gamestate		(gameinst->gamestate)
+#define fizzlein		(gameinst->fizzlein)
+#define spearx			(gameinst->spearx)
+#define speary			(gameinst->speary)
+#define spearangle		(gameinst->spearangle)
+#define spearflag		(gameinst->spearflag)
+
+#define playstate		(gameinst->playstate)
+#define madenoise		(gameinst->madenoise)
+#define objlist			(gameinst->objlist)
+#define objhot			(gameinst->objhot)
+#define new				(gameinst->new)
+#define player			(gameinst->player)
+#define killerobj		(gameinst->killerobj)
+#define objorder		(gameinst->objorder)
+#define objcount		(gameinst->objcount)
+#define actortic		(gameinst->actortic)
+#define tilemap			(gameinst->tilemap)
+#define spotvis			(gameinst->spotvis)
+#define actorat			(gameinst->actorat)
+#define mapsegs			(gameinst->mapsegs)
+#define controlx		(gameinst->controlx)
+#define controly		(gameinst->controly)
+#define buttonstate		(gameinst->buttonstate)
+#define buttonheld		(gameinst->buttonheld)
+#define funnyticount	(gameinst->funnyticount)
+
+#define statobjlist		(gameinst->statobjlist)
+#define laststatobj		(gameinst->laststatobj)
+#define doorobjlist		(gameinst->doorobjlist)
+#define lastdoorobj		(gameinst->lastdoorobj)
+#define doorposition	(gameinst->doorposition)
+#define areaconnect		(gameinst->areaconnect)
+#define areabyplayer	(gameinst->areabyplayer)
+#define pwallstate		(gameinst->pwallstate)
+#define pwallpos		(gameinst->pwallpos)
+#define pwallx			(gameinst->pwallx)
+#define pwally			(gameinst->pwally)
+#define pwalldir		(gameinst->pwalldir)
+
+#define running			(gameinst->running)
+#define thrustspeed		(gameinst->thrustspeed)
+#define plux			(gameinst->plux)
+#define pluy			(gameinst->pluy)
+#define anglefrac		(gameinst->anglefrac)
+#define facecount		(gameinst->facecount)
+#define gotgatgun		(gameinst->gotgatgun)
+#define LastAttacker	(gameinst->LastAttacker)
+
+#define lasttimecount	(gameinst->lasttimecount)
+#define frameon			(gameinst->frameon)
+#define actviewx		(gameinst->actviewx)
+#define actviewheight	(gameinst->actviewheight)
+#define acttransx		(gameinst->acttransx)
+#define acttransy		(gameinst->acttransy)
+
+#define rndindex		(gameinst->rndindex)
+
+
 /*
 =============================================================================
 
@@ -757,6 +954,7 @@ typedef	enum	{
 */
 
 extern	boolean		MS_CheckParm (char *string);
+extern	char		*MS_ParmValue (char *string);
 
 extern	char		str[80],str2[20];
 extern	int			tedlevelnum;
@@ -808,6 +1006,7 @@ boolean 	LoadTheGame(int file,int x,int y);
 boolean		SaveTheGame(int file,int x,int y);
 void 		ShowViewSize (int width);
 void		ShutdownId (void);
+void		InitGame (void);
 
 
 /*
@@ -819,16 +1018,11 @@ void		ShutdownId (void);
 */
 
 
-extern	boolean		ingame,fizzlein;
+extern	boolean		ingame;
 extern	unsigned	latchpics[NUMLATCHPICS];
-extern	gametype	gamestate;
-extern	int			doornum;
 
 extern	char		demoname[13];
 
-extern	long		spearx,speary;
-extern	unsigned	spearangle;
-extern	boolean		spearflag;
 
 
 void 	DrawPlayBorder (void);
@@ -840,6 +1034,7 @@ void 	FizzleOut (void);
 void 	GameLoop (void);
 void ClearMemory (void);
 void PlayDemo (int demonumber);
+void PlayDemoFile (char *name);
 void RecordDemo (void);
 void DrawAllPlayBorder (void);
 void	DrawHighScores(void);
@@ -848,11 +1043,32 @@ void DrawAllPlayBorderSides (void);
 
 // JAB
 #define	PlaySoundLocTile(s,tx,ty)	PlaySoundLocGlobal(s,(((long)(tx) << TILESHIFT) + (1L << (TILESHIFT - 1))),(((long)ty << TILESHIFT) + (1L << (TILESHIFT - 1))))
-#define	PlaySoundLocActor(s,ob)		PlaySoundLocGlobal(s,(ob)->x,(ob)->y)
+#define	PlaySoundLocActor(s,ob)		PlaySoundLocGlobal(s,HOT(ob)->x,HOT(ob)->y)
 void	PlaySoundLocGlobal(word s,fixed gx,fixed gy);
 void UpdateSoundLoc(void);
 
 
+/*
+=============================================================================
+
+						 WL_DEMO DEFINITIONS
+
+=============================================================================
+*/
+
+extern	int			demohashtics;
+extern	long		demotic;
+
+longword DemoStateHash (void);
+void	DemoStartRecord (void);
+void	DemoWriteTic (byte buttonbits, int xmove, int ymove);
+boolean	DemoFinishRecord (char *name);
+boolean	DemoStartPlayback (char *name);
+void	DemoStartMemory (void);
+boolean	DemoReadTic (byte *buttonbits, int *xmove, int *ymove);
+void	DemoStopPlayback (void);
+
+
 /*
 =============================================================================
 
@@ -862,30 +1078,35 @@ void UpdateSoundLoc(void);
 */
 
 #ifdef SPEAR
-extern	long		funnyticount;		// FOR FUNNY BJ FACE
 #endif
 
-extern	exit_t		playstate;
 
-extern	boolean		madenoise;
 
-extern	objtype 	objlist[MAXACTORS],*new,*obj,*player,*lastobj,
-					*objfreelist,*killerobj;
-extern	statobj_t	statobjlist[MAXSTATS],*laststatobj;
-extern	doorobj_t	doorobjlist[MAXDOORS],*lastdoorobj;
+
+//
+// actorat holds 0 for an empty spot, a wall / door / blocking code below
+// 256, or the handle of the actor standing there
+//
+#define ACTORHANDLE(ob)	((word)((ob)-objlist)+256)
+#define HANDLEACTOR(h)	(&objlist[(h)-256])
+#define ISACTOR(h)		((h)>=256)
+
+#define ORDERACTOR(i)	(&objlist[objorder[i]])
+
+#define HOT(ob)			(&objhot[(ob)-objlist])
+
+extern	THREADLOCAL unsigned	tics;
 
 extern	unsigned	farmapylookup[MAPSIZE];
 extern	byte		*nearmapylookup[MAPSIZE];
 
-extern	byte		tilemap[MAPSIZE][MAPSIZE];	// wall values only
-extern	byte		spotvis[MAPSIZE][MAPSIZE];
-extern	objtype		*actorat[MAPSIZE][MAPSIZE];
 
 #define UPDATESIZE			(UPDATEWIDE*UPDATEHIGH)
 extern	byte		update[UPDATESIZE];
 
 extern	boolean		singlestep,godmode,noclip;
 extern	int			extravbls;
+extern	boolean		simonly;
 
 //
 // control info
@@ -897,15 +1118,12 @@ extern	int			buttonscan[NUMBUTTONS];
 extern	int			buttonmouse[4];
 extern	int			buttonjoy[4];
 
-extern	boolean		buttonheld[NUMBUTTONS];
 
 extern	int			viewsize;
 
 //
 // curent user input
 //
-extern	int			controlx,controly;		// range from -100 to 100
-extern	boolean		buttonstate[NUMBUTTONS];
 
 extern	boolean		demorecord,demoplayback;
 extern	char		*demoptr, *lastdemoptr;
@@ -913,16 +1131,31 @@ extern	memptr		demobuffer;
 
 
 
+#define NUMREDSHIFTS	6
+#define NUMWHITESHIFTS	3
+
+extern	byte	redshifts[NUMREDSHIFTS][768];
+extern	byte	whiteshifts[NUMREDSHIFTS][768];
+
 void	InitRedShifts (void);
 void 	FinishPaletteShifts (void);
+int		PaletteShift (void);
 
 void	CenterWindow(word w,word h);
 void 	InitActorList (void);
 void 	GetNewActor (void);
 void 	RemoveObj (objtype *gone);
+void	ActivateActor (objtype *ob);
+void	WakeActor (objtype *ob);
+void	SyncActorTics (void);
+void	DoActors (void);
 void 	PollControls (void);
+void	InjectControls (byte buttonbits, int xmove, int ymove);
 void 	StopMusic(void);
 void 	StartMusic(void);
+void	ResetPlayLoop (void);
+void	ThinkTic (void);
+void	FinishTic (void);
 void	PlayLoop (void);
 void StartDamageFlash (int damage);
 void StartBonusFlash (void);
@@ -966,11 +1199,8 @@ void PicturePause (void);
 extern	unsigned screenloc[3];
 extern	unsigned freelatch;
 
-extern	long 	lasttimecount;
-extern	long 	frameon;
-extern	boolean	fizzlein;
 
-extern	unsigned	wallheight[MAXVIEWWIDTH];
+extern	THREADLOCAL unsigned	wallheight[MAXVIEWWIDTH];
 
 extern	fixed	tileglobal;
 extern	fixed	focallength;
@@ -990,20 +1220,53 @@ extern	fixed 	scale;
 extern	long	heightnumerator;
 
 //
-// refresh variables
+// refresh variables, per thread (see WL_INST)
+//
+extern	THREADLOCAL fixed	viewx,viewy;			// the focal point
+extern	THREADLOCAL int		viewangle;
+extern	THREADLOCAL fixed	viewsin,viewcos;
+
+extern	THREADLOCAL byte		*postsource;
+extern	THREADLOCAL unsigned	postx;
+extern	THREADLOCAL unsigned	postwidth;
+
+//
+// auxiliary channels for W3D_SetAux, filled in as the view is drawn when the
+// pointers are set.  An ID is a kind in the top bits and an index in the
+// low 12; depth is heightnumerator/height, 1/256 tiles out from the view.
 //
-extern	fixed	viewx,viewy;			// the focal point
-extern	int		viewangle;
-extern	fixed	viewsin,viewcos;
+#define AUXID_WALL		0x1000			// | map spot, (tilex<<6)+tiley
+#define AUXID_DOOR		0x2000			// | door number
+#define AUXID_STATIC	0x3000			// | statobjlist index
+#define AUXID_ACTOR		0x4000			// | objlist slot
+#define AUXID_WEAPON	0x5000
+
+#define AUXFAR			0xffff			// depth of floor and ceiling
+
+#define AUXMAP_SEEN		0x01			// a ray crossed the tile
+#define AUXMAP_WALL		0x02			// a ray stopped on its wall
+#define AUXMAP_DOOR		0x04			// a door that was seen
+#define AUXMAP_ACTOR	0x08			// a visable shootable actor
+#define AUXMAP_BONUS	0x10			// a bonus item in a seen tile
+#define AUXMAP_PLAYER	0x20
 
-extern	byte		*postsource;
-extern	unsigned	postx;
-extern	unsigned	postwidth;
+extern	THREADLOCAL uint32_t	*viewargb;	// draw the view here, viewwidth pitch,
+extern	THREADLOCAL const uint32_t	*viewpal;	// through this, when it's set
+
+extern	boolean		columnrender;
+extern	THREADLOCAL byte	*viewcolumns;	// draw columns of viewheight bytes here
+
+extern	long		framebudget;			// microseconds, -framebudget
+extern	THREADLOCAL int	raystep;			// columns each ray stands for
+extern	boolean		textureplanes;			// texture the floor and ceiling
+extern	int			ceilingpage,floorpage;	// with these wall pages
+
+extern	THREADLOCAL word	*auxdepth,*auxid;	// viewwidth*viewheight
+extern	THREADLOCAL word	wallid[MAXVIEWWIDTH];	// what each ray hit
 
 
 extern	int		horizwall[],vertwall[];
 
-extern	unsigned	pwallpos;
 
 
 fixed	FixedByFrac (fixed a, fixed b);
@@ -1011,11 +1274,19 @@ void	TransformActor (objtype *ob);
 void	BuildTables (void);
 void	ClearScreen (void);
 int		CalcRotate (objtype *ob);
+void	CalcViewVariables (void);
+void	FindVisibleObjects (void);
 void	DrawScaleds (void);
 void	CalcTics (void);
 void	FixOfs (void);
+void	RenderView (void);
+void	RenderColumns (byte *dest, int pitch, const byte *lut);
+void	DrawPlaneRows (int first, int last);
 void	ThreeDRefresh (void);
+void	SimRefresh (void);
 void  FarScalePost (void);
+word	AuxDepth (unsigned height);
+void	AuxMap (byte *map);
 
 /*
 =============================================================================
@@ -1092,6 +1363,8 @@ extern	int			maxscale,maxscaleshl2;
 
 extern	boolean	insetupscaling;
 
+extern	THREADLOCAL word	lineid,linedepth;	// for the aux channels
+
 void SetupScaling (int maxscaleheight);
 void ScaleShape (int xcenter, int shapenum, unsigned height);
 void SimpleScaleShape (int xcenter, int shapenum, unsigned height);
@@ -1107,12 +1380,7 @@ void SimpleScaleShape (int xcenter, int shapenum, unsigned height);
 //
 // player state info
 //
-extern	boolean		running;
-extern	long		thrustspeed;
-extern	unsigned	plux,pluy;		// player coordinates scaled to unsigned
 
-extern	int			anglefrac;
-extern	int			facecount;
 
 void	SpawnPlayer (int tilex, int tiley, int dir);
 void 	DrawFace (void);
@@ -1131,6 +1399,7 @@ void	DrawAmmo (void);
 void	GiveAmmo (int ammo);
 void	GiveKey (int key);
 void	GetBonus (statobj_t *check);
+void	GrabBonuses (void);
 
 void	Thrust (int angle, long speed);
 
@@ -1142,19 +1411,10 @@ void	Thrust (int angle, long speed);
 =============================================================================
 */
 
-extern	doorobj_t	doorobjlist[MAXDOORS],*lastdoorobj;
-extern	int			doornum;
 
-extern	unsigned	doorposition[MAXDOORS],pwallstate;
 
-extern	byte		areaconnect[NUMAREAS][NUMAREAS];
 
-extern	boolean		areabyplayer[NUMAREAS];
 
-extern unsigned	pwallstate;
-extern unsigned	pwallpos;			// amount a pushable wall has been moved (0-63)
-extern unsigned	pwallx,pwally;
-extern int			pwalldir;
 
 
 void InitDoorList (void);
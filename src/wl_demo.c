@@ -0,0 +1,540 @@
+// WL_DEMO.C
+
+#include "wl_def.h"
+
+/*
+=============================================================================
+
+						STREAMED DEMO FORMAT
+						--------------------
+
+A recorded demo is a short header followed by a run length coded stream of
+tic records.  The stream goes to disk DEMOCHUNK bytes at a time, so there
+is no limit on how long a recording can be.
+
+	"WDM"		magic
+	byte		DEMOVERSION
+	byte		mapon
+	byte		episode
+	byte		difficulty
+	byte		hash interval in demo tics, 0 if the demo has no hashes
+
+	byte 1-DEMOMAXRUN	the following input repeats for that many tics
+		byte	buttonbits
+		byte	controlx
+		byte	controly
+
+	DEMO_HASH	followed by a 32 bit little endian DemoStateHash, taken
+				before the next tic runs
+	DEMO_END
+
+A demo tic is one PollControls call, DEMOTICS game tics.
+
+The demos built into the graphics file use the original format: a level
+byte, a 16 bit length, and three bytes for each tic.  They are still read
+from memory.
+
+=============================================================================
+*/
+
+/*
+=============================================================================
+
+						 LOCAL CONSTANTS
+
+=============================================================================
+*/
+
+#define DEMOVERSION		2
+#define DEMOHEADER		8
+#define DEMOCHUNK		4096
+#define DEMOMAXRUN		0x7f
+#define DEMO_HASH		0x80
+#define DEMO_END		0x81
+
+#define DEMOTEMPNAME	"DEMO.TMP"
+
+/*
+=============================================================================
+
+						 GLOBAL VARIABLES
+
+=============================================================================
+*/
+
+int			demohashtics = 16;		// 0 to record without state hashes
+long		demotic;				// demo tics recorded / played so far
+
+/*
+=============================================================================
+
+						 LOCAL VARIABLES
+
+=============================================================================
+*/
+
+static	int			demohandle = -1;
+static	boolean		streameddemo;		// playback from a file, not demoptr
+
+static	byte		demochunk[DEMOCHUNK];
+static	int			chunkpos,chunklen;
+
+static	byte		runrecord[3];
+static	int			runcount;
+
+static	longword	statehash;
+
+
+/*
+=============================================================================
+
+							STATE HASH
+
+=============================================================================
+*/
+
+/*
+==================
+=
+= HashLong
+=
+= FNV-1a over the low 32 bits, so the hash doesn't depend on sizeof(long)
+=
+==================
+*/
+
+static void HashLong (long value)
+{
+	int	i;
+
+	for (i=0;i<4;i++)
+	{
+		statehash ^= (byte)value;
+		statehash *= 16777619u;
+		value >>= 8;
+	}
+}
+
+
+/*
+==================
+=
+= DemoStateHash
+=
+= Hashes everything a desync shows up in.  States are hashed by contents,
+= not address, so demos can be checked against a different build.
+=
+==================
+*/
+
+longword DemoStateHash (void)
+{
+	objtype	*ob;
+	byte	*tile;
+	int		i;
+
+	SyncActorTics ();
+
+	statehash = 2166136261u;
+
+	HashLong (rndindex);
+
+	HashLong (gamestate.difficulty);
+	HashLong (gamestate.mapon);
+	HashLong (gamestate.score);
+	HashLong (gamestate.lives);
+	HashLong (gamestate.health);
+	HashLong (gamestate.ammo);
+	HashLong (gamestate.keys);
+	HashLong (gamestate.weapon);
+	HashLong (gamestate.attackframe);
+	HashLong (gamestate.attackcount);
+	HashLong (gamestate.weaponframe);
+	HashLong (gamestate.secretcount);
+	HashLong (gamestate.treasurecount);
+	HashLong (gamestate.killcount);
+	HashLong (gamestate.TimeCount);
+
+	for (i=0;i<objcount;i++)
+	{
+		ob = ORDERACTOR(i);
+		HashLong (ob->active);
+		HashLong (HOT(ob)->ticcount);
+		HashLong (ob->obclass);
+		HashLong (HOT(ob)->state->shapenum);
+		HashLong (HOT(ob)->state->tictime);
+		HashLong (ob->flags);
+		HashLong (ob->distance);
+		HashLong (ob->dir);
+		HashLong (HOT(ob)->x);
+		HashLong (HOT(ob)->y);
+		HashLong (ob->areanumber);
+		HashLong (ob->angle);
+		HashLong (ob->hitpoints);
+		HashLong (ob->speed);
+		HashLong (ob->temp1);
+		HashLong (ob->temp2);
+		HashLong (ob->temp3);
+	}
+
+	tile = &tilemap[0][0];
+	for (i=0;i<MAPSIZE*MAPSIZE;i++)
+	{
+		statehash ^= *tile++;
+		statehash *= 16777619u;
+	}
+
+	for (i=0;i<gameinst->doornum;i++)
+		HashLong (doorposition[i]);
+
+	return statehash;
+}
+
+
+/*
+=============================================================================
+
+							RECORDING
+
+=============================================================================
+*/
+
+/*
+==================
+=
+= FlushDemoChunk
+=
+==================
+*/
+
+static void FlushDemoChunk (void)
+{
+	if (chunkpos && !CA_FarWrite (demohandle,demochunk,chunkpos))
+		Quit ("FlushDemoChunk: Can't write demo!");
+	chunkpos = 0;
+}
+
+
+static void PutDemoByte (byte value)
+{
+	if (chunkpos == DEMOCHUNK)
+		FlushDemoChunk ();
+	demochunk[chunkpos++] = value;
+}
+
+
+static void FlushDemoRun (void)
+{
+	if (!runcount)
+		return;
+
+	PutDemoByte (runcount);
+	PutDemoByte (runrecord[0]);
+	PutDemoByte (runrecord[1]);
+	PutDemoByte (runrecord[2]);
+	runcount = 0;
+}
+
+
+/*
+==================
+=
+= DemoStartRecord
+=
+= Opens the stream on a temporary file, DemoFinishRecord names it.  The
+= level must already be set up in gamestate.
+=
+==================
+*/
+
+void DemoStartRecord (void)
+{
+	demohandle = open (DEMOTEMPNAME,O_CREAT | O_TRUNC | O_BINARY | O_WRONLY,
+		S_IREAD | S_IWRITE);
+	if (demohandle == -1)
+		Quit ("DemoStartRecord: Can't create "DEMOTEMPNAME"!");
+
+	chunkpos = 0;
+	runcount = 0;
+	demotic = 0;
+
+	PutDemoByte ('W');
+	PutDemoByte ('D');
+	PutDemoByte ('M');
+	PutDemoByte (DEMOVERSION);
+	PutDemoByte (gamestate.mapon);
+	PutDemoByte (gamestate.episode);
+	PutDemoByte (gamestate.difficulty);
+	PutDemoByte (demohashtics);
+}
+
+
+/*
+==================
+=
+= DemoWriteTic
+=
+= Called by PollControls with the input for the tic about to run
+=
+==================
+*/
+
+void DemoWriteTic (byte buttonbits, int xmove, int ymove)
+{
+	if (demohashtics && demotic && !(demotic%demohashtics))
+	{
+		longword	hash;
+
+		FlushDemoRun ();
+		hash = DemoStateHash ();
+		PutDemoByte (DEMO_HASH);
+		PutDemoByte (hash);
+		PutDemoByte (hash>>8);
+		PutDemoByte (hash>>16);
+		PutDemoByte (hash>>24);
+	}
+
+	if (runcount && (runcount == DEMOMAXRUN
+		|| runrecord[0] != buttonbits
+		|| runrecord[1] != (byte)xmove
+		|| runrecord[2] != (byte)ymove) )
+		FlushDemoRun ();
+
+	runrecord[0] = buttonbits;
+	runrecord[1] = xmove;
+	runrecord[2] = ymove;
+	runcount++;
+
+	demotic++;
+}
+
+
+/*
+==================
+=
+= DemoFinishRecord
+=
+= Closes the stream and renames it to name, or throws it away if name is
+= NULL.  Returns false if the rename failed.
+=
+==================
+*/
+
+boolean DemoFinishRecord (char *name)
+{
+	if (demohandle == -1)
+		return false;
+
+	FlushDemoRun ();
+	PutDemoByte (DEMO_END);
+	FlushDemoChunk ();
+	close (demohandle);
+	demohandle = -1;
+
+	if (!name)
+	{
+		unlink (DEMOTEMPNAME);
+		return true;
+	}
+
+	unlink (name);
+	return !rename (DEMOTEMPNAME,name);
+}
+
+
+/*
+=============================================================================
+
+							PLAYBACK
+
+=============================================================================
+*/
+
+/*
+==================
+=
+= GetDemoByte / PeekDemoByte
+=
+= A short read or the end of the file reads as DEMO_END
+=
+==================
+*/
+
+static int PeekDemoByte (void)
+{
+	if (chunkpos == chunklen)
+	{
+		chunkpos = 0;
+		chunklen = read (demohandle,demochunk,DEMOCHUNK);
+		if (chunklen <= 0)
+		{
+			chunklen = 0;
+			return DEMO_END;
+		}
+	}
+	return demochunk[chunkpos];
+}
+
+
+static int GetDemoByte (void)
+{
+	int	value;
+
+	value = PeekDemoByte ();
+	if (chunkpos < chunklen)
+		chunkpos++;
+	return value;
+}
+
+
+/*
+==================
+=
+= DemoStartPlayback
+=
+= Opens a streamed demo and sets the level and difficulty from its header,
+= so it must come after NewGame.
+= Returns false if the file isn't there or isn't a streamed demo.
+=
+==================
+*/
+
+boolean DemoStartPlayback (char *name)
+{
+	byte	header[DEMOHEADER];
+
+	demohandle = open (name,O_RDONLY | O_BINARY);
+	if (demohandle == -1)
+		return false;
+
+	if (!CA_FarRead (demohandle,header,DEMOHEADER)
+		|| header[0] != 'W' || header[1] != 'D' || header[2] != 'M'
+		|| header[3] != DEMOVERSION)
+	{
+		close (demohandle);
+		demohandle = -1;
+		return false;
+	}
+
+	gamestate.mapon = header[4];
+	gamestate.episode = header[5];
+	gamestate.difficulty = header[6];
+
+	streameddemo = true;
+	chunkpos = chunklen = 0;
+	runcount = 0;
+	demotic = 0;
+
+	return true;
+}
+
+
+/*
+==================
+=
+= DemoStartMemory
+=
+= Plays back a demo in the original format from memory at demoptr
+=
+==================
+*/
+
+void DemoStartMemory (void)
+{
+	int	length;
+
+	streameddemo = false;
+	demotic = 0;
+
+	gamestate.mapon = *demoptr++;
+	length = *(uint16_t *)demoptr;  // demo format stores 16-bit length
+	demoptr += 2;
+	lastdemoptr = demoptr-4+length;
+}
+
+
+/*
+==================
+=
+= DemoReadTic
+=
+= Called by PollControls for the input of the tic about to run.  Returns
+= true when that was the last tic of the demo.
+=
+==================
+*/
+
+boolean DemoReadTic (byte *buttonbits, int *xmove, int *ymove)
+{
+	int			token;
+	longword	hash;
+	char		error[60];
+
+	demotic++;
+
+	if (!streameddemo)
+	{
+		*buttonbits = *demoptr++;
+		*xmove = (signed char)*demoptr++;
+		*ymove = (signed char)*demoptr++;
+		return demoptr == lastdemoptr;
+	}
+
+	while (!runcount)
+	{
+		token = GetDemoByte ();
+
+		if (token == DEMO_HASH)
+		{
+			hash = GetDemoByte ();
+			hash |= (longword)GetDemoByte ()<<8;
+			hash |= (longword)GetDemoByte ()<<16;
+			hash |= (longword)GetDemoByte ()<<24;
+			if (hash != DemoStateHash ())
+			{
+				sprintf (error,"Demo desync before tic %ld!",demotic);
+				Quit (error);
+			}
+			continue;
+		}
+
+		if (token == DEMO_END || token > DEMOMAXRUN)
+		{
+			//
+			// ran off the end, play one idle tic and stop
+			//
+			*buttonbits = 0;
+			*xmove = *ymove = 0;
+			return true;
+		}
+
+		runcount = token;
+		runrecord[0] = GetDemoByte ();
+		runrecord[1] = GetDemoByte ();
+		runrecord[2] = GetDemoByte ();
+	}
+
+	*buttonbits = runrecord[0];
+	*xmove = (signed char)runrecord[1];
+	*ymove = (signed char)runrecord[2];
+	runcount--;
+
+	return !runcount && PeekDemoByte () == DEMO_END;
+}
+
+
+/*
+==================
+=
+= DemoStopPlayback
+=
+==================
+*/
+
+void DemoStopPlayback (void)
+{
+	if (streameddemo && demohandle != -1)
+		close (demohandle);
+	demohandle = -1;
+	streameddemo = false;
+}
@@ -2,6 +2,9 @@
 
 #include "wl_def.h"
 #include <stdint.h>
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
 
 //#define DEBUGWALLS
 //#define DEBUGTICS
@@ -35,10 +38,7 @@ unsigned screenloc[3]= {PAGE1START,PAGE2START,PAGE3START};
 #endif
 unsigned freelatch = FREESTART;
 
-long 	lasttimecount;
-long 	frameon;
-
-unsigned	wallheight[MAXVIEWWIDTH];
+THREADLOCAL unsigned	wallheight[MAXVIEWWIDTH];
 
 fixed	tileglobal	= TILEGLOBAL;
 fixed	mindist		= MINDIST;
@@ -54,49 +54,68 @@ fixed 		sintable[ANGLES+ANGLES/4], *costable = sintable+(ANGLES/4);
 //
 // refresh variables
 //
-fixed	viewx,viewy;			// the focal point
-int		viewangle;
-fixed	viewsin,viewcos;
+// Everything a refresh computes from scratch is THREADLOCAL, so game
+// instances on different threads can refresh at the same time.  The actor
+// projections (actviewx etc.) are read by the next tic's attack scans, so
+// they live in the instance instead.
+//
+THREADLOCAL fixed	viewx,viewy;			// the focal point
+THREADLOCAL int		viewangle;
+THREADLOCAL fixed	viewsin,viewcos;
+
+//
+// points DrawScaleds hands to TransformBatch, statics first then actors
+//
+#define MAXTRANSFORM	(MAXSTATS+MAXACTORS)
+
+THREADLOCAL fixed	batchgx[MAXTRANSFORM],batchgy[MAXTRANSFORM];
+THREADLOCAL fixed	batchnx[MAXTRANSFORM],batchny[MAXTRANSFORM];
 
 
 
 fixed	FixedByFrac (fixed a, fixed b);
 void	TransformActor (objtype *ob);
+void	ProjectActor (int slot, fixed nx, fixed ny);
+boolean	ProjectTile (fixed nx, fixed ny, int *dispx, int *dispheight);
+void	TransformBatch (int count);
 void	BuildTables (void);
 void	ClearScreen (void);
 int		CalcRotate (objtype *ob);
+void	FindVisibleObjects (void);
 void	DrawScaleds (void);
 void	CalcTics (void);
 void	FixOfs (void);
 void	ThreeDRefresh (void);
+void	SimRefresh (void);
 
 
 
 //
 // wall optimization variables
 //
-int		lastside;		// true for vertical
-long	lastintercept;
-int		lasttilehit;
+THREADLOCAL int		lastside;		// true for vertical
+THREADLOCAL long	lastintercept;
+THREADLOCAL int		lasttilehit;
 
 
 //
 // ray tracing variables
 //
-int			focaltx,focalty,viewtx,viewty;
+THREADLOCAL int			focaltx,focalty,viewtx,viewty;
 
-int			midangle,angle;
-unsigned	xpartial,ypartial;
-unsigned	xpartialup,xpartialdown,ypartialup,ypartialdown;
-unsigned	xinttile,yinttile;
+THREADLOCAL int			midangle,angle;
+THREADLOCAL unsigned	xpartial,ypartial;
+THREADLOCAL unsigned	xpartialup,xpartialdown,ypartialup,ypartialdown;
+THREADLOCAL unsigned	xinttile,yinttile;
 
-unsigned	tilehit;
-unsigned	pixx;
+THREADLOCAL unsigned	tilehit;
+THREADLOCAL unsigned	pixx;
+THREADLOCAL int			raystep = 1;	// columns each ray stands for
 
-int		xtile,ytile;
-int		xtilestep,ytilestep;
-long	xintercept,yintercept;
-long	xstep,ystep;
+THREADLOCAL int		xtile,ytile;
+THREADLOCAL int		xtilestep,ytilestep;
+THREADLOCAL long	xintercept,yintercept;
+THREADLOCAL long	xstep,ystep;
 
 int		horizwall[MAXWALLTILES],vertwall[MAXWALLTILES];
 
@@ -185,12 +204,15 @@ fixed FixedByFrac (fixed a, fixed b)
 void TransformActor (objtype *ob)
 {
 	fixed gx,gy,gxt,gyt,nx,ny;
+	int	slot;
+
+	slot = ob-objlist;
 
 //
 // translate point to view centered coordinates
 //
-	gx = ob->x-viewx;
-	gy = ob->y-viewy;
+	gx = objhot[slot].x-viewx;
+	gy = objhot[slot].y-viewy;
 
 //
 // calculate newx
@@ -208,24 +230,40 @@ void TransformActor (objtype *ob)
 	gyt = FixedByFrac(gy,viewcos);
 	ny = gyt+gxt;
 
+	ProjectActor (slot,nx,ny);
+}
+
+
+/*
+========================
+=
+= ProjectActor
+=
+= Perspective part of TransformActor, nx/ny are already rotated
+=
+========================
+*/
+
+void ProjectActor (int slot, fixed nx, fixed ny)
+{
 //
 // calculate perspective ratio
 //
-	ob->transx = nx;
-	ob->transy = ny;
+	acttransx[slot] = nx;
+	acttransy[slot] = ny;
 
 	if (nx<mindist)			// too close, don't overflow the divide
 	{
-	  ob->viewheight = 0;
+	  actviewheight[slot] = 0;
 	  return;
 	}
 
-	ob->viewx = centerx + ny*scale/nx;
+	actviewx[slot] = centerx + ny*scale/nx;
 
 //
 // calculate height (heightnumerator/(nx>>8))
 //
-	ob->viewheight = (int)(heightnumerator / (nx >> 8));
+	actviewheight[slot] = (int)(heightnumerator / (nx >> 8));
 }
 
 //==========================================================================
@@ -275,7 +313,22 @@ boolean TransformTile (int tx, int ty, int *dispx, int *dispheight)
 	gyt = FixedByFrac(gy,viewcos);
 	ny = gyt+gxt;
 
+	return ProjectTile (nx,ny,dispx,dispheight);
+}
+
+
+/*
+========================
+=
+= ProjectTile
+=
+= Perspective part of TransformTile, nx/ny are already rotated
+=
+========================
+*/
 
+boolean ProjectTile (fixed nx, fixed ny, int *dispx, int *dispheight)
+{
 //
 // calculate perspective ratio
 //
@@ -303,6 +356,87 @@ boolean TransformTile (int tx, int ty, int *dispx, int *dispheight)
 
 //==========================================================================
 
+/*
+========================
+=
+= TransformBatch
+=
+= Rotates count view centered points in batchgx/batchgy into batchnx /
+= batchny, the same as the FixedByFrac pairs in TransformActor and
+= TransformTile without the fudge.
+=
+= viewcos/viewsin are unpacked from signed magnitude once.  FixedByFrac
+= truncates the magnitude, so each product is rounded toward zero here
+= by adding 0xffff to negative products before the shift.  That keeps
+= every result bit identical to the scalar path.
+=
+========================
+*/
+
+#define FRACMUL(a,f)	((fixed)(((int64_t)(a)*(f) \
+						+ ((((int64_t)(a)*(f))>>63)&0xffff))>>16))
+
+void TransformBatch (int count)
+{
+	int32_t	c,s;
+	int		i;
+
+	c = viewcos&0xffff;
+	if (viewcos < 0)
+		c = -c;
+	s = viewsin&0xffff;
+	if (viewsin < 0)
+		s = -s;
+
+	i = 0;
+
+#ifdef __ARM_NEON
+	{
+		int32x2_t	vc,vs;
+		int64x2_t	round;
+		int32x4_t	gx,gy;
+
+		vc = vdup_n_s32 (c);
+		vs = vdup_n_s32 (s);
+		round = vdupq_n_s64 (0xffff);
+
+#define NEONMUL(dst,a,f)											\
+{																	\
+	int64x2_t	lo,hi;												\
+	lo = vmull_s32 (vget_low_s32(a),f);								\
+	hi = vmull_s32 (vget_high_s32(a),f);							\
+	lo = vaddq_s64 (lo,vandq_s64(vshrq_n_s64(lo,63),round));			\
+	hi = vaddq_s64 (hi,vandq_s64(vshrq_n_s64(hi,63),round));			\
+	dst = vcombine_s32 (vmovn_s64(vshrq_n_s64(lo,16)),				\
+		vmovn_s64(vshrq_n_s64(hi,16)));								\
+}
+
+		for ( ; i+4<=count ; i+=4)
+		{
+			int32x4_t	xc,ys,xs,yc;
+
+			gx = vld1q_s32 (&batchgx[i]);
+			gy = vld1q_s32 (&batchgy[i]);
+			NEONMUL(xc,gx,vc);
+			NEONMUL(ys,gy,vs);
+			NEONMUL(xs,gx,vs);
+			NEONMUL(yc,gy,vc);
+			vst1q_s32 (&batchnx[i],vsubq_s32(xc,ys));
+			vst1q_s32 (&batchny[i],vaddq_s32(yc,xs));
+		}
+#undef NEONMUL
+	}
+#endif
+
+	for ( ; i<count ; i++)
+	{
+		batchnx[i] = FRACMUL(batchgx[i],c)-FRACMUL(batchgy[i],s);
+		batchny[i] = FRACMUL(batchgy[i],c)+FRACMUL(batchgx[i],s);
+	}
+}
+
+//==========================================================================
+
 /*
 ====================
 =
@@ -346,9 +480,247 @@ int	CalcHeight (void)
 ===================
 */
 
-byte		*postsource;
-unsigned	postx;
-unsigned	postwidth;
+THREADLOCAL byte		*postsource;
+THREADLOCAL unsigned	postx;
+THREADLOCAL unsigned	postwidth;
+
+THREADLOCAL uint32_t	*viewargb;
+THREADLOCAL const uint32_t	*viewpal;
+
+boolean					columnrender;	// ThreeDRefresh uses RenderColumns
+THREADLOCAL byte		*viewcolumns;
+static THREADLOCAL byte	viewcolumnbuf[MAXVIEWWIDTH*(200-STATUSLINES)];
+
+THREADLOCAL word		*auxdepth,*auxid;
+THREADLOCAL word		wallid[MAXVIEWWIDTH];
+
+static THREADLOCAL byte	ceilingcolor,floorcolor;	// set by SetPlaneColors
+
+boolean					textureplanes;			// DrawPlanes instead of FlatPost
+int						ceilingpage = 0,floorpage = 1;	// wall pages they use
+static THREADLOCAL int	posttop[MAXVIEWWIDTH],postbottom[MAXVIEWWIDTH];
+
+/*
+===================
+=
+= AuxDepth
+=
+= The depth channel value for a wallheight or sprite height
+=
+===================
+*/
+
+word AuxDepth (unsigned height)
+{
+	long	depth;
+
+	if (!height)
+		return AUXFAR;
+
+	depth = heightnumerator/height;
+	if (depth >= AUXFAR)
+		depth = AUXFAR-1;
+
+	return depth;
+}
+
+
+/*
+===================
+=
+= AuxPost
+=
+= Fills the aux channels for the columns of the post, the wall between
+= toprow and bottomrow and floor or ceiling above and below it
+=
+===================
+*/
+
+static void AuxPost (int toprow, int bottomrow)
+{
+	int		x,y,right;
+	word	depth,id;
+
+	right = postx+postwidth;
+	if (right > viewwidth)
+		right = viewwidth;
+
+	for (x=postx;x<right;x++)
+	{
+		if (auxdepth)
+		{
+			depth = AuxDepth (wallheight[x]);
+			for (y=0;y<toprow;y++)
+				auxdepth[y*viewwidth+x] = AUXFAR;
+			for ( ;y<bottomrow;y++)
+				auxdepth[y*viewwidth+x] = depth;
+			for ( ;y<viewheight;y++)
+				auxdepth[y*viewwidth+x] = AUXFAR;
+		}
+
+		if (auxid)
+		{
+			id = wallid[x];
+			for (y=0;y<toprow;y++)
+				auxid[y*viewwidth+x] = 0;
+			for ( ;y<bottomrow;y++)
+				auxid[y*viewwidth+x] = id;
+			for ( ;y<viewheight;y++)
+				auxid[y*viewwidth+x] = 0;
+		}
+	}
+}
+
+
+/*
+===================
+=
+= FlatPost
+=
+= Fills the columns of the post above toprow with the ceiling and from
+= bottomrow down with the floor.  Every view column belongs to exactly one
+= post, so this stands in for clearing the whole view first, and each
+= pixel is only written once before the sprites.
+=
+= With textureplanes set the rows are only noted, for DrawPlanes.
+=
+===================
+*/
+
+static void FlatPost (int toprow, int bottomrow)
+{
+	int			x, y, right, width;
+	byte		*dest;
+	uint32_t	*argb, ceilingargb, floorargb;
+
+	right = postx+postwidth;
+	if (right > viewwidth)
+		right = viewwidth;
+	width = right-(int)postx;
+	if (width <= 0)
+		return;
+
+	if (textureplanes)
+	{
+		for (x = postx; x < right; x++)
+		{
+			posttop[x] = toprow;
+			postbottom[x] = bottomrow;
+		}
+		return;
+	}
+
+	if (viewcolumns)
+	{
+		for (x = postx; x < right; x++)
+		{
+			dest = viewcolumns + x*viewheight;
+			memset (dest, ceilingcolor, toprow);
+			memset (dest + bottomrow, floorcolor, viewheight - bottomrow);
+		}
+		return;
+	}
+
+	if (viewargb)
+	{
+		ceilingargb = viewpal[ceilingcolor];
+		floorargb = viewpal[floorcolor];
+		for (y = 0; y < toprow; y++)
+		{
+			argb = viewargb + y*viewwidth;
+			for (x = postx; x < right; x++)
+				argb[x] = ceilingargb;
+		}
+		for (y = bottomrow; y < viewheight; y++)
+		{
+			argb = viewargb + y*viewwidth;
+			for (x = postx; x < right; x++)
+				argb[x] = floorargb;
+		}
+		return;
+	}
+
+	dest = sdl_framebuffer + screenofs + postx;
+	for (y = 0; y < toprow; y++)
+		memset (dest + y*320, ceilingcolor, width);
+	for (y = bottomrow; y < viewheight; y++)
+		memset (dest + y*320, floorcolor, width);
+}
+
+
+/*
+===================
+=
+= ScalePostARGB
+=
+= ScalePost's inner loop for viewargb, the palette lookup done as it goes
+=
+===================
+*/
+
+static void ScalePostARGB (int toprow, int bottomrow, int srcfrac, int srcstep)
+{
+	int			x, y, right, texel;
+	uint32_t	col, *dest;
+
+	right = postx+postwidth;
+	if (right > viewwidth)
+		right = viewwidth;
+
+	dest = viewargb + toprow*viewwidth;
+	for (y = toprow; y < bottomrow; y++)
+	{
+		texel = srcfrac >> 16;
+		if (texel > 63)
+			texel = 63;
+		col = viewpal[postsource[texel]];
+
+		for (x = postx; x < right; x++)
+			dest[x] = col;
+
+		dest += viewwidth;
+		srcfrac += srcstep;
+	}
+}
+
+
+/*
+===================
+=
+= ScalePostColumns
+=
+= ScalePost for viewcolumns: the first column is scaled straight down,
+= and the rest of a wide post are copies of it
+=
+===================
+*/
+
+static void ScalePostColumns (int toprow, int bottomrow, int srcfrac, int srcstep)
+{
+	int		x, y, right, texel;
+	byte	*dest;
+
+	right = postx+postwidth;
+	if (right > viewwidth)
+		right = viewwidth;
+	if ((int)postx >= right)
+		return;
+
+	dest = viewcolumns + postx*viewheight;
+	for (y = toprow; y < bottomrow; y++)
+	{
+		texel = srcfrac >> 16;
+		if (texel > 63)
+			texel = 63;
+		dest[y] = postsource[texel];
+		srcfrac += srcstep;
+	}
+
+	for (x = postx+1; x < right; x++)
+		memcpy (viewcolumns + x*viewheight + toprow, dest + toprow,
+			bottomrow-toprow);
+}
+
 
 void ScalePost (void)
 {
@@ -361,7 +733,12 @@ void ScalePost (void)
 
 	height = wallheight[postx] >> 2;  // height in pixels (wallheight has 2 fractional bits)
 	if (height <= 0)
+	{
+		FlatPost (viewheight/2,viewheight/2);
+		if (auxdepth || auxid)
+			AuxPost (viewheight/2,viewheight/2);
 		return;
+	}
 
 	// clamp to max scale height
 	if (height > maxscaleshl2 >> 2)
@@ -384,10 +761,26 @@ void ScalePost (void)
 	if (bottomrow > viewheight)
 		bottomrow = viewheight;
 
+	FlatPost (toprow,bottomrow);
+	if (auxdepth || auxid)
+		AuxPost (toprow,bottomrow);
+
 	src = postsource;
 	if (!src)
 		return;
 
+	if (viewargb)
+	{
+		ScalePostARGB (toprow,bottomrow,srcfrac,srcstep);
+		return;
+	}
+
+	if (viewcolumns)
+	{
+		ScalePostColumns (toprow,bottomrow,srcfrac,srcstep);
+		return;
+	}
+
 	for (y = toprow; y < bottomrow; y++)
 	{
 		int texel = srcfrac >> 16;
@@ -442,7 +835,7 @@ void HitVertWall (void)
 		if (texture == (unsigned)((uintptr_t)postsource & 0xFFF))
 		{
 		// wide scale
-			postwidth++;
+			postwidth += raystep;
 			wallheight[pixx] = wallheight[pixx-1];
 			return;
 		}
@@ -452,7 +845,7 @@ void HitVertWall (void)
 			postsource = (byte *)PM_GetPage(wallpic) + texture;
 			// wallpic not set here -- reuse the page base from postsource
 			postsource = (byte *)((uintptr_t)postsource & ~0xFFFUL) + texture;
-			postwidth = 1;
+			postwidth = raystep;
 			postx = pixx;
 		}
 	}
@@ -467,7 +860,7 @@ void HitVertWall (void)
 
 		lasttilehit = tilehit;
 		postx = pixx;
-		postwidth = 1;
+		postwidth = raystep;
 
 		if (tilehit & 0x40)
 		{								// check for adjacent doors
@@ -514,7 +907,7 @@ void HitHorizWall (void)
 		if (texture == (unsigned)((uintptr_t)postsource & 0xFFF))
 		{
 		// wide scale
-			postwidth++;
+			postwidth += raystep;
 			wallheight[pixx] = wallheight[pixx-1];
 			return;
 		}
@@ -522,7 +915,7 @@ void HitHorizWall (void)
 		{
 			ScalePost ();
 			postsource = (byte *)((uintptr_t)postsource & ~0xFFFUL) + texture;
-			postwidth = 1;
+			postwidth = raystep;
 			postx = pixx;
 		}
 	}
@@ -537,7 +930,7 @@ void HitHorizWall (void)
 
 		lasttilehit = tilehit;
 		postx = pixx;
-		postwidth = 1;
+		postwidth = raystep;
 
 		if (tilehit & 0x40)
 		{								// check for adjacent doors
@@ -580,7 +973,7 @@ void HitHorizDoor (void)
 		if (texture == (unsigned)((uintptr_t)postsource & 0xFFF))
 		{
 		// wide scale
-			postwidth++;
+			postwidth += raystep;
 			wallheight[pixx] = wallheight[pixx-1];
 			return;
 		}
@@ -588,7 +981,7 @@ void HitHorizDoor (void)
 		{
 			ScalePost ();
 			postsource = (byte *)((uintptr_t)postsource & ~0xFFFUL) + texture;
-			postwidth = 1;
+			postwidth = raystep;
 			postx = pixx;
 		}
 	}
@@ -600,7 +993,7 @@ void HitHorizDoor (void)
 		lastside = 2;
 		lasttilehit = tilehit;
 		postx = pixx;
-		postwidth = 1;
+		postwidth = raystep;
 
 		switch (doorobjlist[doornum].lock)
 		{
@@ -647,7 +1040,7 @@ void HitVertDoor (void)
 		if (texture == (unsigned)((uintptr_t)postsource & 0xFFF))
 		{
 		// wide scale
-			postwidth++;
+			postwidth += raystep;
 			wallheight[pixx] = wallheight[pixx-1];
 			return;
 		}
@@ -655,7 +1048,7 @@ void HitVertDoor (void)
 		{
 			ScalePost ();
 			postsource = (byte *)((uintptr_t)postsource & ~0xFFFUL) + texture;
-			postwidth = 1;
+			postwidth = raystep;
 			postx = pixx;
 		}
 	}
@@ -667,7 +1060,7 @@ void HitVertDoor (void)
 		lastside = 2;
 		lasttilehit = tilehit;
 		postx = pixx;
-		postwidth = 1;
+		postwidth = raystep;
 
 		switch (doorobjlist[doornum].lock)
 		{
@@ -725,7 +1118,7 @@ void HitHorizPWall (void)
 		if (texture == (unsigned)((uintptr_t)postsource & 0xFFF))
 		{
 		// wide scale
-			postwidth++;
+			postwidth += raystep;
 			wallheight[pixx] = wallheight[pixx-1];
 			return;
 		}
@@ -733,7 +1126,7 @@ void HitHorizPWall (void)
 		{
 			ScalePost ();
 			postsource = (byte *)((uintptr_t)postsource & ~0xFFFUL) + texture;
-			postwidth = 1;
+			postwidth = raystep;
 			postx = pixx;
 		}
 	}
@@ -745,7 +1138,7 @@ void HitHorizPWall (void)
 
 		lasttilehit = tilehit;
 		postx = pixx;
-		postwidth = 1;
+		postwidth = raystep;
 
 		wallpic = horizwall[tilehit&63];
 
@@ -788,7 +1181,7 @@ void HitVertPWall (void)
 		if (texture == (unsigned)((uintptr_t)postsource & 0xFFF))
 		{
 		// wide scale
-			postwidth++;
+			postwidth += raystep;
 			wallheight[pixx] = wallheight[pixx-1];
 			return;
 		}
@@ -796,7 +1189,7 @@ void HitVertPWall (void)
 		{
 			ScalePost ();
 			postsource = (byte *)((uintptr_t)postsource & ~0xFFFUL) + texture;
-			postwidth = 1;
+			postwidth = raystep;
 			postx = pixx;
 		}
 	}
@@ -808,7 +1201,7 @@ void HitVertPWall (void)
 
 		lasttilehit = tilehit;
 		postx = pixx;
-		postwidth = 1;
+		postwidth = raystep;
 
 		wallpic = vertwall[tilehit&63];
 
@@ -840,36 +1233,165 @@ unsigned vgaCeiling[]=
 /*
 =====================
 =
-= VGAClearScreen
+= SetPlaneColors
+=
+= The level's ceiling color and the floor, for FlatPost to fill in around
+= the walls as they're scaled
+=
+=====================
+*/
+
+static void SetPlaneColors (void)
+{
+	ceilingcolor = (byte)vgaCeiling[gamestate.episode*10+gamestate.mapon];
+	floorcolor = 0x19;
+}
+
+
+/*
+=====================
+=
+= PlaneSpan
+=
+= Draws pixels x1 to x2-1 of view row y from the 64*64 wall page tex,
+= starting at xfrac,yfrac in the map and stepping xstep,ystep a pixel.
+= The texels are gathered into a row first and then stored in one go.
 =
 =====================
 */
 
-void VGAClearScreen (void)
+static void PlaneSpan (int y, int x1, int x2, fixed xfrac, fixed yfrac,
+	fixed xstep, fixed ystep, const byte *tex)
 {
-	unsigned ceilingword = vgaCeiling[gamestate.episode*10+mapon];
-	byte ceilingcolor = (byte)(ceilingword & 0xFF);
-	byte floorcolor = 0x19;
-	int x, y;
-	int halfheight = viewheight / 2;
-	int ybase = screenofs / 320;  // vertical offset in the framebuffer
-	int xbase = screenofs % 320;  // horizontal offset in the framebuffer
-
-	// draw ceiling (top half)
-	for (y = 0; y < halfheight; y++)
-	{
-		for (x = 0; x < viewwidth; x++)
+	byte		texels[MAXVIEWWIDTH];
+	int			i, count;
+	byte		*dest;
+	uint32_t	*argb;
+
+	count = x2-x1;
+	i = 0;
+
+#ifdef __ARM_NEON
+	{
+		static const int32_t	lane[4] = {0,1,2,3};
+		int32x4_t	vx,vy,sx,sy,umask,vmask;
+		int32_t		ofs[4];
+
+		vx = vmlaq_n_s32 (vdupq_n_s32(xfrac),vld1q_s32(lane),xstep);
+		vy = vmlaq_n_s32 (vdupq_n_s32(yfrac),vld1q_s32(lane),ystep);
+		sx = vdupq_n_s32 (xstep*4);
+		sy = vdupq_n_s32 (ystep*4);
+		umask = vdupq_n_s32 (0xfc0);
+		vmask = vdupq_n_s32 (63);
+
+		for ( ; i+4<=count ; i+=4)
 		{
-			sdl_framebuffer[(ybase + y) * 320 + xbase + x] = ceilingcolor;
+			vst1q_s32 (ofs,vorrq_s32(vandq_s32(vshrq_n_s32(vx,4),umask),
+				vandq_s32(vshrq_n_s32(vy,10),vmask)));
+			texels[i] = tex[ofs[0]];
+			texels[i+1] = tex[ofs[1]];
+			texels[i+2] = tex[ofs[2]];
+			texels[i+3] = tex[ofs[3]];
+			vx = vaddq_s32 (vx,sx);
+			vy = vaddq_s32 (vy,sy);
 		}
+		xfrac += i*xstep;
+		yfrac += i*ystep;
+	}
+#endif
+
+	for ( ; i<count ; i++)
+	{
+		texels[i] = tex[((xfrac>>4)&0xfc0) | ((yfrac>>10)&63)];
+		xfrac += xstep;
+		yfrac += ystep;
+	}
+
+	if (viewcolumns)
+	{
+		dest = viewcolumns + x1*viewheight + y;
+		for (i=0;i<count;i++,dest+=viewheight)
+			*dest = texels[i];
+	}
+	else if (viewargb)
+	{
+		argb = viewargb + y*viewwidth + x1;
+		for (i=0;i<count;i++)
+			argb[i] = viewpal[texels[i]];
 	}
+	else
+		memcpy (sdl_framebuffer + screenofs + y*320 + x1, texels, count);
+}
+
+
+/*
+=====================
+=
+= DrawPlaneRows
+=
+= Textures ceiling rows first to last-1 and the floor rows that mirror
+= them, wherever the posts left them showing.  A ceiling row and its
+= floor row are the same distance out from the view, so across the row
+= the map point moves a fixed step per pixel.  Nothing carries over from
+= one row to the next, so any band of rows can be drawn on its own.
+=
+= Grown from the planar DrawSpans in WOLFHACK.C.
+=
+=====================
+*/
 
-	// draw floor (bottom half)
-	for (y = halfheight; y < viewheight; y++)
+void DrawPlaneRows (int first, int last)
+{
+	int		y, floory, x, x1, halfheight;
+	int32_t	c, s;
+	fixed	step, dist, xstep, ystep, xfrac, yfrac;
+	const byte	*ceilingtex, *floortex;
+
+	c = viewcos&0xffff;
+	if (viewcos < 0)
+		c = -c;
+	s = viewsin&0xffff;
+	if (viewsin < 0)
+		s = -s;
+
+	ceilingtex = PM_GetPage (ceilingpage);
+	floortex = PM_GetPage (floorpage);
+	halfheight = viewheight/2;
+
+	for (y = first; y < last; y++)
 	{
-		for (x = 0; x < viewwidth; x++)
+	//
+	// a wall that ends at this row and its floor mirror is that many
+	// pixels tall, and scale*TILEGLOBAL/height is how far out it stands
+	//
+		step = TILEGLOBAL/(2*(halfheight-y)-1);
+		dist = scale*step;
+		xstep = FRACMUL(step,s);
+		ystep = FRACMUL(step,c);
+		xfrac = viewx + FRACMUL(dist,c) + (1-viewwidth)*xstep/2;
+		yfrac = viewy - FRACMUL(dist,s) + (1-viewwidth)*ystep/2;
+
+		for (x = 0; x < viewwidth; )
 		{
-			sdl_framebuffer[(ybase + y) * 320 + xbase + x] = floorcolor;
+			while (x < viewwidth && posttop[x] <= y)
+				x++;
+			for (x1 = x; x < viewwidth && posttop[x] > y; x++)
+				;
+			if (x > x1)
+				PlaneSpan (y,x1,x,xfrac+x1*xstep,yfrac+x1*ystep,
+					xstep,ystep,ceilingtex);
+		}
+
+		floory = viewheight-1-y;
+		for (x = 0; x < viewwidth; )
+		{
+			while (x < viewwidth && postbottom[x] > floory)
+				x++;
+			for (x1 = x; x < viewwidth && postbottom[x] <= floory; x++)
+				;
+			if (x > x1)
+				PlaneSpan (floory,x1,x,xfrac+x1*xstep,yfrac+x1*ystep,
+					xstep,ystep,floortex);
 		}
 	}
 }
@@ -891,7 +1413,7 @@ int	CalcRotate (objtype *ob)
 	// this isn't exactly correct, as it should vary by a trig value,
 	// but it is close enough with only eight rotations
 
-	viewangle = player->angle + (centerx - ob->viewx)/8;
+	viewangle = player->angle + (centerx - actviewx[ob-objlist])/8;
 
 	if (ob->obclass == rocketobj || ob->obclass == hrocketobj)
 		angle =  (viewangle-180)- ob->angle;
@@ -904,7 +1426,7 @@ int	CalcRotate (objtype *ob)
 	while (angle<0)
 		angle+=ANGLES;
 
-	if (ob->state->rotate == 2)             // 2 rotation pain frame
+	if (HOT(ob)->state->rotate == 2)             // 2 rotation pain frame
 		return 4*(angle/(ANGLES/2));        // seperated by 3 (art layout...)
 
 	return angle/(ANGLES/8);
@@ -914,71 +1436,62 @@ int	CalcRotate (objtype *ob)
 /*
 =====================
 =
-= DrawScaleds
+= FindVisibleObjects
 =
-= Draws all objects that are visable
+= The game side of the refresh, run every tic whether or not the frame is
+= drawn.  Statics in seen tiles are projected; bonus items are picked up
+= in the tic by GrabBonuses.  Actors in or next to a seen tile are
+= activated, projected and flagged FL_VISABLE for the attack code.
+= DrawScaleds only reads the results.
 =
 =====================
 */
 
-#define MAXVISABLE	50
-
-typedef struct
-{
-	int	viewx,
-		viewheight,
-		shapenum;
-} visobj_t;
-
-visobj_t	vislist[MAXVISABLE],*visptr,*visstep,*farthest;
+THREADLOCAL statobj_t	*batchstat[MAXSTATS];
+THREADLOCAL int			statviewx[MAXSTATS],statviewheight[MAXSTATS];
+THREADLOCAL byte		batchslot[MAXACTORS];
+THREADLOCAL int			numstats,numacts;
 
-void DrawScaleds (void)
+void FindVisibleObjects (void)
 {
-	int 		i,j,least,numvisable,height;
-	memptr		shape;
+	int 		i,slot;
 	byte		*tilespot,*visspot;
-	int			shapenum;
 	unsigned	spotloc;
 
 	statobj_t	*statptr;
 	objtype		*obj;
-
-	visptr = &vislist[0];
+	objhot_t	*hot;
 
 //
-// place static objects
+// gather static objects
 //
+	numstats = 0;
 	for (statptr = &statobjlist[0] ; statptr !=laststatobj ; statptr++)
 	{
-		if ((visptr->shapenum = statptr->shapenum) == -1)
+		if (statptr->shapenum == -1)
 			continue;						// object has been deleted
 
 		if (!*statptr->visspot)
 			continue;						// not visable
 
-		if (TransformTile (statptr->tilex,statptr->tiley
-			,&visptr->viewx,&visptr->viewheight) && statptr->flags & FL_BONUS)
-		{
-			GetBonus (statptr);
-			continue;
-		}
-
-		if (!visptr->viewheight)
-			continue;						// to close to the object
-
-		if (visptr < &vislist[MAXVISABLE-1])	// don't let it overflow
-			visptr++;
+		batchstat[numstats] = statptr;
+		batchgx[numstats] = ((long)statptr->tilex<<TILESHIFT)+0x8000-viewx;
+		batchgy[numstats] = ((long)statptr->tiley<<TILESHIFT)+0x8000-viewy;
+		numstats++;
 	}
 
 //
-// place active objects
+// gather active objects
 //
-	for (obj = player->next;obj;obj=obj->next)
+	numacts = 0;
+	for (i=1;i<objcount;i++)
 	{
-		if (!(visptr->shapenum = obj->state->shapenum))
+		obj = ORDERACTOR(i);
+		hot = &objhot[objorder[i]];
+		if (!hot->state->shapenum)
 			continue;						// no shape
 
-		spotloc = (obj->tilex<<6)+obj->tiley;	// optimize: keep in struct?
+		spotloc = (hot->tilex<<6)+hot->tiley;	// optimize: keep in struct?
 		visspot = &spotvis[0][0]+spotloc;
 		tilespot = &tilemap[0][0]+spotloc;
 
@@ -995,27 +1508,124 @@ void DrawScaleds (void)
 		|| ( *(visspot+64) && !*(tilespot+64) )
 		|| ( *(visspot+63) && !*(tilespot+63) ) )
 		{
-			obj->active = true;
-			TransformActor (obj);
-			if (!obj->viewheight)
-				continue;						// too close or far away
-
-			visptr->viewx = obj->viewx;
-			visptr->viewheight = obj->viewheight;
-			if (visptr->shapenum == -1)
-				visptr->shapenum = obj->temp1;	// special shape
-
-			if (obj->state->rotate)
-				visptr->shapenum += CalcRotate (obj);
-
-			if (visptr < &vislist[MAXVISABLE-1])	// don't let it overflow
-				visptr++;
-			obj->flags |= FL_VISABLE;
+			ActivateActor (obj);
+			batchslot[numacts] = objorder[i];
+			batchgx[numstats+numacts] = hot->x-viewx;
+			batchgy[numstats+numacts] = hot->y-viewy;
+			numacts++;
 		}
 		else
 			obj->flags &= ~FL_VISABLE;
 	}
 
+	TransformBatch (numstats+numacts);
+
+//
+// project static objects; the bonus items in reach are the ones GrabBonuses
+// left, which the game never draws
+//
+	for (i=0;i<numstats;i++)
+	{
+		statptr = batchstat[i];
+
+		if (ProjectTile (batchnx[i]-0x2000,batchny[i]	// 0x2000 is size of object
+			,&statviewx[i],&statviewheight[i]) && statptr->flags & FL_BONUS)
+			batchstat[i] = NULL;			// not drawn this frame
+	}
+
+//
+// project active objects
+//
+	for (i=0;i<numacts;i++)
+	{
+		slot = batchslot[i];
+		ProjectActor (slot,batchnx[numstats+i]-ACTORSIZE,batchny[numstats+i]);
+		if (actviewheight[slot])
+			objlist[slot].flags |= FL_VISABLE;
+	}
+}
+
+
+/*
+=====================
+=
+= DrawScaleds
+=
+= Draws all objects that are visable
+=
+=====================
+*/
+
+#define MAXVISABLE	50
+
+typedef struct
+{
+	int	viewx,
+		viewheight,
+		shapenum;
+	word	id;						// for the aux ID channel
+} visobj_t;
+
+THREADLOCAL visobj_t	vislist[MAXVISABLE],*visptr,*visstep,*farthest;
+
+void DrawScaleds (void)
+{
+	int 		i,j,least,numvisable,height;
+	int			slot;
+	memptr		shape;
+	int			shapenum;
+
+	statobj_t	*statptr;
+	objtype		*obj;
+
+	visptr = &vislist[0];
+
+//
+// place static objects
+//
+	for (i=0;i<numstats;i++)
+	{
+		statptr = batchstat[i];
+		if (!statptr)
+			continue;						// in reach of the player
+
+		if (!statviewheight[i])
+			continue;						// to close to the object
+
+		visptr->shapenum = statptr->shapenum;
+		visptr->viewx = statviewx[i];
+		visptr->viewheight = statviewheight[i];
+		visptr->id = AUXID_STATIC | (statptr-&statobjlist[0]);
+
+		if (visptr < &vislist[MAXVISABLE-1])	// don't let it overflow
+			visptr++;
+	}
+
+//
+// place active objects
+//
+	for (i=0;i<numacts;i++)
+	{
+		slot = batchslot[i];
+		obj = &objlist[slot];
+
+		if (!actviewheight[slot])
+			continue;						// too close or far away
+
+		visptr->shapenum = objhot[slot].state->shapenum;
+		visptr->viewx = actviewx[slot];
+		visptr->viewheight = actviewheight[slot];
+		visptr->id = AUXID_ACTOR | slot;
+		if (visptr->shapenum == -1)
+			visptr->shapenum = obj->temp1;	// special shape
+
+		if (objhot[slot].state->rotate)
+			visptr->shapenum += CalcRotate (obj);
+
+		if (visptr < &vislist[MAXVISABLE-1])	// don't let it overflow
+			visptr++;
+	}
+
 //
 // draw from back to front
 //
@@ -1039,6 +1649,7 @@ void DrawScaleds (void)
 		//
 		// draw farthest
 		//
+		lineid = farthest->id;
 		ScaleShape(farthest->viewx,farthest->shapenum,farthest->viewheight);
 
 		farthest->viewheight = 32000;
@@ -1065,10 +1676,13 @@ void DrawPlayerWeapon (void)
 {
 	int	shapenum;
 
+	lineid = AUXID_WEAPON;
+
 #ifndef SPEAR
 	if (gamestate.victoryflag)
 	{
-		if (player->state == &s_deathcam && (TimeCount&32) )
+		if (HOT(player)->state == &s_deathcam
+		&& ((simonly ? gamestate.TimeCount : TimeCount)&32) )	// no clock
 			SimpleScaleShape(viewwidth/2,SPR_DEATHCAM,viewheight+1);
 		return;
 	}
@@ -1153,232 +1767,531 @@ void	FixOfs (void)
 
 //==========================================================================
 
+/*
+=============================================================================
+
+							 RAY CASTING
+
+AsmRefresh traces the view's columns RAYPACKET at a time.  A packet keeps
+each of its rays' DDA state in a lane of its own and steps them together,
+alternating vertical and horizontal grid lines like the one ray loop did.
+A lane that comes to a solid wall is resolved on the spot and masked out
+of the stepping; one that comes to a door or a pushwall is left where it
+is and finished by TraceRay, the one ray loop, once the packet is done.
+Either way every ray stops on the same tile with the same intercepts, and
+marks the same spotvis, as it would on its own.
+
+The walls are then drawn in column order from the stopped rays, since the
+posts are built up from one column to the next.
+
+=============================================================================
+*/
+
+#define RAYPACKET	4				// columns traced side by side
+
+enum {hit_vertwall,hit_horizwall,hit_vertdoor,hit_horizdoor};
+
+typedef struct
+{
+	long		xintercept,yintercept;
+	long		xstep,ystep;
+	int			xtile,ytile;
+	int			xtilestep,ytilestep;
+	unsigned	tilehit;
+	int			hitspot;
+	int			hit;				// hit_ routine that draws it
+	int			resume;				// for TraceRay: 1 at the x check, 2 at y
+} ray_t;
+
+static THREADLOCAL boolean	markonly;
+
+
 /*
 ====================
 =
-= AsmRefresh
+= StartRay
 =
-= Raycaster core - casts one ray per screen column using DDA
+= Sets up the ray down column x
 =
 ====================
 */
 
-void AsmRefresh (void)
+static void StartRay (ray_t *r, int x)
 {
-	int     angle;
-	long    xstep_local, ystep_local;
-	long    xintercept_local, yintercept_local;
-	unsigned xtile_local, ytile_local;
-	int     xtilestep_local, ytilestep_local;
-	int     xspot, yspot;
-	unsigned tile;
+	int		angle;
+
+	angle = midangle + pixelangle[x];
 
-	for (pixx = 0; pixx < (unsigned)viewwidth; pixx++)
+	if (angle < 0)
+		angle += FINEANGLES;
+	if (angle >= FINEANGLES)
+		angle -= FINEANGLES;
+
+	//
+	// setup xstep/ystep based on angle quadrant
+	//
+	if (angle < ANG90)
 	{
-		angle = midangle + pixelangle[pixx];
+		// first quadrant: right and up
+		r->xtilestep = 1;
+		r->ytilestep = -1;
 
-		if (angle < 0)
-			angle += FINEANGLES;
-		if (angle >= FINEANGLES)
-			angle -= FINEANGLES;
+		r->xstep = finetangent[ANG90 - 1 - angle];
+		r->ystep = -finetangent[angle];
 
-		//
-		// setup xstep/ystep based on angle quadrant
-		//
-		if (angle < ANG90)
-		{
-			// first quadrant: right and up
-			xtilestep = 1;
-			ytilestep = -1;
+		r->xintercept = ((long)viewtx << TILESHIFT) + TILEGLOBAL;
+		r->xintercept += FixedByFrac(xpartialup, r->xstep);
+		r->xtile = viewtx + 1;
 
-			xstep = finetangent[ANG90 - 1 - angle];
-			ystep = -finetangent[angle];
+		r->yintercept = ((long)viewty << TILESHIFT);
+		r->yintercept += FixedByFrac(ypartialup, r->ystep);
+		r->ytile = viewty - 1;
+	}
+	else if (angle < ANG180)
+	{
+		// second quadrant: left and up
+		r->xtilestep = -1;
+		r->ytilestep = -1;
 
-			xintercept = ((long)viewtx << TILESHIFT) + TILEGLOBAL;
-			xintercept += FixedByFrac(xpartialup, xstep);
-			xtile = viewtx + 1;
+		r->xstep = -finetangent[angle - ANG90];
+		r->ystep = -finetangent[ANG180 - 1 - angle];
 
-			yintercept = ((long)viewty << TILESHIFT);
-			yintercept += FixedByFrac(ypartialup, ystep);
-			ytile = viewty - 1;
-		}
-		else if (angle < ANG180)
-		{
-			// second quadrant: left and up
-			xtilestep = -1;
-			ytilestep = -1;
+		r->xintercept = ((long)viewtx << TILESHIFT);
+		r->xintercept += FixedByFrac(xpartialdown, r->xstep);
+		r->xtile = viewtx - 1;
 
-			xstep = -finetangent[angle - ANG90];
-			ystep = -finetangent[ANG180 - 1 - angle];
+		r->yintercept = ((long)viewty << TILESHIFT);
+		r->yintercept += FixedByFrac(ypartialup, r->ystep);
+		r->ytile = viewty - 1;
+	}
+	else if (angle < ANG270)
+	{
+		// third quadrant: left and down
+		r->xtilestep = -1;
+		r->ytilestep = 1;
 
-			xintercept = ((long)viewtx << TILESHIFT);
-			xintercept += FixedByFrac(xpartialdown, xstep);
-			xtile = viewtx - 1;
+		r->xstep = -finetangent[ANG270 - 1 - angle];
+		r->ystep = finetangent[angle - ANG180];
 
-			yintercept = ((long)viewty << TILESHIFT);
-			yintercept += FixedByFrac(ypartialup, ystep);
-			ytile = viewty - 1;
-		}
-		else if (angle < ANG270)
-		{
-			// third quadrant: left and down
-			xtilestep = -1;
-			ytilestep = 1;
+		r->xintercept = ((long)viewtx << TILESHIFT);
+		r->xintercept += FixedByFrac(xpartialdown, r->xstep);
+		r->xtile = viewtx - 1;
 
-			xstep = -finetangent[ANG270 - 1 - angle];
-			ystep = finetangent[angle - ANG180];
+		r->yintercept = ((long)viewty << TILESHIFT) + TILEGLOBAL;
+		r->yintercept += FixedByFrac(ypartialdown, r->ystep);
+		r->ytile = viewty + 1;
+	}
+	else
+	{
+		// fourth quadrant: right and down
+		r->xtilestep = 1;
+		r->ytilestep = 1;
 
-			xintercept = ((long)viewtx << TILESHIFT);
-			xintercept += FixedByFrac(xpartialdown, xstep);
-			xtile = viewtx - 1;
+		r->xstep = finetangent[angle - ANG270];
+		r->ystep = finetangent[ANG360 - 1 - angle];
 
-			yintercept = ((long)viewty << TILESHIFT) + TILEGLOBAL;
-			yintercept += FixedByFrac(ypartialdown, ystep);
-			ytile = viewty + 1;
-		}
-		else
-		{
-			// fourth quadrant: right and down
-			xtilestep = 1;
-			ytilestep = 1;
+		r->xintercept = ((long)viewtx << TILESHIFT) + TILEGLOBAL;
+		r->xintercept += FixedByFrac(xpartialup, r->xstep);
+		r->xtile = viewtx + 1;
 
-			xstep = finetangent[angle - ANG270];
-			ystep = finetangent[ANG360 - 1 - angle];
+		r->yintercept = ((long)viewty << TILESHIFT) + TILEGLOBAL;
+		r->yintercept += FixedByFrac(ypartialdown, r->ystep);
+		r->ytile = viewty + 1;
+	}
 
-			xintercept = ((long)viewtx << TILESHIFT) + TILEGLOBAL;
-			xintercept += FixedByFrac(xpartialup, xstep);
-			xtile = viewtx + 1;
+	r->resume = 0;
+}
 
-			yintercept = ((long)viewty << TILESHIFT) + TILEGLOBAL;
-			yintercept += FixedByFrac(ypartialdown, ystep);
-			ytile = viewty + 1;
-		}
 
-		//
-		// trace the ray through the map via DDA
-		//
-		// We alternate checking vertical (x) and horizontal (y) grid intersections
-		//
-		for (;;)
+/*
+====================
+=
+= TraceRay
+=
+= Traces one ray through the map via DDA until it stops, from the x check
+= or with fromy set from the y check
+=
+====================
+*/
+
+static void TraceRay (ray_t *r, boolean fromy)
+{
+	int			xspot, yspot;
+	unsigned	tile;
+	long		intercept;
+	int			doornum;
+
+	if (fromy)
+		goto horizcheck;
+
+	for (;;)
+	{
+		// check vertical (x) grid line intersection
+		xspot = (r->xtile << 6) + (r->yintercept >> TILESHIFT);
+		if (xspot >= 0 && xspot < MAPSIZE * MAPSIZE)
 		{
-			// check vertical (x) grid line intersection
-			xspot = (xtile << 6) + (yintercept >> TILESHIFT);
-			if (xspot >= 0 && xspot < MAPSIZE * MAPSIZE)
+			tile = ((byte *)tilemap)[xspot];
+			if (tile)
 			{
-				tile = ((byte *)tilemap)[xspot];
-				if (tile)
+				r->tilehit = tile;
+				r->hitspot = xspot;
+				if (tile & 0x80)
 				{
-					tilehit = tile;
-					if (tilehit & 0x80)
-					{
-						// door tile
-						long intercept;
-						int doornum;
-
-						// check door at half-tile offset
-						intercept = yintercept + (ystep >> 1);
-						doornum = tilehit & 0x7f;
-
-						if ((intercept >> TILESHIFT) != ytile)
-							goto passvert;  // stepped into next tile
-
-						// check if door is open enough
-						if ( (unsigned)(intercept >> 4) & 0xfc0
-							 && ((unsigned)((intercept - doorposition[doornum]) >> 4) & 0xfc0) <= 0xfc0 )
-						{
-							yintercept = intercept;
-							xintercept = ((long)xtile << TILESHIFT) + (TILEGLOBAL / 2);
-							HitVertDoor();
-							break;
-						}
-						goto passvert;
-					}
-					else if (tilehit & 0x40)
-					{
-						// pushwall check
-						// check if we hit the pushwall offset
-						long intercept = yintercept + ((long)pwallpos * ystep) / 64;
+					// door tile, check door at half-tile offset
+					intercept = r->yintercept + (r->ystep >> 1);
+					doornum = tile & 0x7f;
 
-						xintercept = ((long)xtile << TILESHIFT) + ((long)pwallpos << 10);
-						if (xtilestep == -1)
-							xintercept = ((long)xtile << TILESHIFT) + TILEGLOBAL - ((long)pwallpos << 10);
+					if ((intercept >> TILESHIFT) != r->ytile)
+						goto passvert;  // stepped into next tile
 
-						yintercept = intercept;
-						HitVertWall();
-						break;
-					}
-					else
+					// check if door is open enough
+					if ( (unsigned)(intercept >> 4) & 0xfc0
+						 && ((unsigned)((intercept - doorposition[doornum]) >> 4) & 0xfc0) <= 0xfc0 )
 					{
-						// solid wall
-						xintercept = (long)xtile << TILESHIFT;
-						HitVertWall();
-						break;
+						r->yintercept = intercept;
+						r->xintercept = ((long)r->xtile << TILESHIFT) + (TILEGLOBAL / 2);
+						r->hit = hit_vertdoor;
+						return;
 					}
+					goto passvert;
+				}
+				else if (tile & 0x40)
+				{
+					// pushwall, check if we hit the pushwall offset
+					intercept = r->yintercept + ((long)pwallpos * r->ystep) / 64;
+
+					r->xintercept = ((long)r->xtile << TILESHIFT) + ((long)pwallpos << 10);
+					if (r->xtilestep == -1)
+						r->xintercept = ((long)r->xtile << TILESHIFT) + TILEGLOBAL - ((long)pwallpos << 10);
+
+					r->yintercept = intercept;
+					r->hit = hit_vertwall;
+					return;
+				}
+				else
+				{
+					// solid wall
+					r->xintercept = (long)r->xtile << TILESHIFT;
+					r->hit = hit_vertwall;
+					return;
 				}
 			}
+		}
 
 passvert:
-			// advance to next vertical grid line
-			xtile += xtilestep;
-			yintercept += ystep;
-
-			// check horizontal (y) grid line intersection
-			yspot = (ytile << 6) + (xintercept >> TILESHIFT);
-			if (yspot >= 0 && yspot < MAPSIZE * MAPSIZE)
+		// the ray saw through this tile
+		if (xspot >= 0 && xspot < MAPSIZE * MAPSIZE)
+			((byte *)spotvis)[xspot] = 1;
+
+		// advance to next vertical grid line
+		r->xtile += r->xtilestep;
+		r->yintercept += r->ystep;
+
+horizcheck:
+		// check horizontal (y) grid line intersection
+		yspot = (r->ytile << 6) + (r->xintercept >> TILESHIFT);
+		if (yspot >= 0 && yspot < MAPSIZE * MAPSIZE)
+		{
+			tile = ((byte *)tilemap)[yspot];
+			if (tile)
 			{
-				tile = ((byte *)tilemap)[yspot];
-				if (tile)
+				r->tilehit = tile;
+				r->hitspot = yspot;
+				if (tile & 0x80)
 				{
-					tilehit = tile;
-					if (tilehit & 0x80)
-					{
-						// door tile
-						long intercept;
-						int doornum;
-
-						intercept = xintercept + (xstep >> 1);
-						doornum = tilehit & 0x7f;
-
-						if ((intercept >> TILESHIFT) != xtile)
-							goto passhoriz;
-
-						if ( (unsigned)(intercept >> 4) & 0xfc0
-							 && ((unsigned)((intercept - doorposition[doornum]) >> 4) & 0xfc0) <= 0xfc0 )
-						{
-							xintercept = intercept;
-							yintercept = ((long)ytile << TILESHIFT) + (TILEGLOBAL / 2);
-							HitHorizDoor();
-							break;
-						}
-						goto passhoriz;
-					}
-					else if (tilehit & 0x40)
-					{
-						// pushwall
-						long intercept = xintercept + ((long)pwallpos * xstep) / 64;
+					// door tile
+					intercept = r->xintercept + (r->xstep >> 1);
+					doornum = tile & 0x7f;
 
-						yintercept = ((long)ytile << TILESHIFT) + ((long)pwallpos << 10);
-						if (ytilestep == -1)
-							yintercept = ((long)ytile << TILESHIFT) + TILEGLOBAL - ((long)pwallpos << 10);
+					if ((intercept >> TILESHIFT) != r->xtile)
+						goto passhoriz;
 
-						xintercept = intercept;
-						HitHorizWall();
-						break;
-					}
-					else
+					if ( (unsigned)(intercept >> 4) & 0xfc0
+						 && ((unsigned)((intercept - doorposition[doornum]) >> 4) & 0xfc0) <= 0xfc0 )
 					{
-						// solid wall
-						yintercept = (long)ytile << TILESHIFT;
-						HitHorizWall();
-						break;
+						r->xintercept = intercept;
+						r->yintercept = ((long)r->ytile << TILESHIFT) + (TILEGLOBAL / 2);
+						r->hit = hit_horizdoor;
+						return;
 					}
+					goto passhoriz;
+				}
+				else if (tile & 0x40)
+				{
+					// pushwall
+					intercept = r->xintercept + ((long)pwallpos * r->xstep) / 64;
+
+					r->yintercept = ((long)r->ytile << TILESHIFT) + ((long)pwallpos << 10);
+					if (r->ytilestep == -1)
+						r->yintercept = ((long)r->ytile << TILESHIFT) + TILEGLOBAL - ((long)pwallpos << 10);
+
+					r->xintercept = intercept;
+					r->hit = hit_horizwall;
+					return;
+				}
+				else
+				{
+					// solid wall
+					r->yintercept = (long)r->ytile << TILESHIFT;
+					r->hit = hit_horizwall;
+					return;
 				}
 			}
+		}
 
 passhoriz:
-			// advance to next horizontal grid line
-			ytile += ytilestep;
-			xintercept += xstep;
+		// the ray saw through this tile
+		if (yspot >= 0 && yspot < MAPSIZE * MAPSIZE)
+			((byte *)spotvis)[yspot] = 1;
+
+		// advance to next horizontal grid line
+		r->ytile += r->ytilestep;
+		r->xintercept += r->xstep;
+	}
+}
+
+
+/*
+====================
+=
+= TracePacket
+=
+= Steps the first lanes rays together until each has stopped on a wall or
+= been left for TraceRay.  The lanes are 64 bits wide, the same as long,
+= so the intercepts run just as far out of the map as they would alone.
+=
+====================
+*/
+
+#ifdef __ARM_NEON
+// a[] += s[] & live[], two lanes a vector
+#define PACKETSTEP(a,s)													\
+	for (l=0;l<RAYPACKET;l+=2)											\
+		vst1q_s64 (&a[l],vaddq_s64(vld1q_s64(&a[l]),					\
+			vandq_s64(vld1q_s64(&s[l]),vld1q_s64(&live[l]))))
+// spot[] = (tile[]<<6) + (intercept[]>>TILESHIFT)
+#define PACKETSPOT(tile,intercept)										\
+	for (l=0;l<RAYPACKET;l+=2)											\
+		vst1q_s64 (&spot[l],vaddq_s64(vshlq_n_s64(vld1q_s64(&tile[l]),6),	\
+			vshrq_n_s64(vld1q_s64(&intercept[l]),TILESHIFT)))
+#else
+#define PACKETSTEP(a,s)													\
+	for (l=0;l<RAYPACKET;l++)											\
+		a[l] += s[l] & live[l]
+#define PACKETSPOT(tile,intercept)										\
+	for (l=0;l<RAYPACKET;l++)											\
+		spot[l] = (tile[l]<<6) + (intercept[l]>>TILESHIFT)
+#endif
+
+static void TracePacket (ray_t *rays, int lanes)
+{
+	int64_t		xt[RAYPACKET],yt[RAYPACKET],xts[RAYPACKET],yts[RAYPACKET];
+	int64_t		xi[RAYPACKET],yi[RAYPACKET],xs[RAYPACKET],ys[RAYPACKET];
+	int64_t		spot[RAYPACKET],live[RAYPACKET];
+	unsigned	tile;
+	int			l,left;
+	ray_t		*r;
+
+	for (l=0;l<RAYPACKET;l++)
+	{
+		r = &rays[l < lanes ? l : 0];	// spare lanes are never live
+		xt[l] = r->xtile;
+		yt[l] = r->ytile;
+		xts[l] = r->xtilestep;
+		yts[l] = r->ytilestep;
+		xi[l] = r->xintercept;
+		yi[l] = r->yintercept;
+		xs[l] = r->xstep;
+		ys[l] = r->ystep;
+		live[l] = l < lanes ? -1 : 0;
+	}
+
+	left = lanes;
+	while (left)
+	{
+	//
+	// vertical grid lines
+	//
+		PACKETSPOT(xt,yi);
+		for (l=0;l<lanes;l++)
+		{
+			if (!live[l] || (uint64_t)spot[l] >= MAPSIZE*MAPSIZE)
+				continue;
+			tile = ((byte *)tilemap)[spot[l]];
+			if (!tile)
+			{
+				((byte *)spotvis)[spot[l]] = 1;		// the ray saw through it
+				continue;
+			}
+
+			r = &rays[l];
+			r->xtile = xt[l];
+			r->ytile = yt[l];
+			r->xintercept = xi[l];
+			r->yintercept = yi[l];
+			if (tile & 0xc0)
+				r->resume = 1;				// a door or pushwall, for TraceRay
+			else
+			{
+				r->tilehit = tile;
+				r->hitspot = spot[l];
+				r->xintercept = (long)xt[l] << TILESHIFT;
+				r->hit = hit_vertwall;
+			}
+			live[l] = 0;
+			left--;
+		}
+		PACKETSTEP(xt,xts);
+		PACKETSTEP(yi,ys);
+
+		if (!left)
+			break;
+
+	//
+	// horizontal grid lines
+	//
+		PACKETSPOT(yt,xi);
+		for (l=0;l<lanes;l++)
+		{
+			if (!live[l] || (uint64_t)spot[l] >= MAPSIZE*MAPSIZE)
+				continue;
+			tile = ((byte *)tilemap)[spot[l]];
+			if (!tile)
+			{
+				((byte *)spotvis)[spot[l]] = 1;
+				continue;
+			}
+
+			r = &rays[l];
+			r->xtile = xt[l];
+			r->ytile = yt[l];
+			r->xintercept = xi[l];
+			r->yintercept = yi[l];
+			if (tile & 0xc0)
+				r->resume = 2;
+			else
+			{
+				r->tilehit = tile;
+				r->hitspot = spot[l];
+				r->yintercept = (long)yt[l] << TILESHIFT;
+				r->hit = hit_horizwall;
+			}
+			live[l] = 0;
+			left--;
+		}
+		PACKETSTEP(yt,yts);
+		PACKETSTEP(xi,xs);
+	}
+
+	for (l=0;l<lanes;l++)
+		if (rays[l].resume)
+			TraceRay (&rays[l],rays[l].resume == 2);
+}
+
+#undef PACKETSTEP
+#undef PACKETSPOT
+
+
+/*
+====================
+=
+= HitRay
+=
+= Draws the wall a stopped ray found at column pixx, and notes what it was
+=
+====================
+*/
+
+static void HitRay (ray_t *r)
+{
+	int		x;
+
+	xintercept = r->xintercept;
+	yintercept = r->yintercept;
+	xstep = r->xstep;
+	ystep = r->ystep;
+	xtile = r->xtile;
+	ytile = r->ytile;
+	xtilestep = r->xtilestep;
+	ytilestep = r->ytilestep;
+	tilehit = r->tilehit;
+
+	if (!markonly)
+	{
+		switch (r->hit)
+		{
+		case hit_vertwall:
+			HitVertWall ();
+			break;
+		case hit_horizwall:
+			HitHorizWall ();
+			break;
+		case hit_vertdoor:
+			HitVertDoor ();
+			break;
+		case hit_horizdoor:
+			HitHorizDoor ();
+			break;
+		}
+	}
+
+	//
+	// what the ray stopped on, for the ID channel and AuxMap
+	//
+	if (tilehit & 0x80)
+		wallid[pixx] = AUXID_DOOR | (tilehit & 0x7f);
+	else
+		wallid[pixx] = AUXID_WALL | r->hitspot;
+
+	//
+	// the other columns of the ray, for the sprites to clip against
+	//
+	for (x = pixx+1; x < (int)pixx+raystep && x < viewwidth; x++)
+	{
+		wallheight[x] = wallheight[pixx];
+		wallid[x] = wallid[pixx];
+	}
+}
+
+
+/*
+====================
+=
+= AsmRefresh
+=
+= Raycaster core - casts a ray down every column, RAYPACKET rays at a
+= time, and draws raystep columns at once from the ray down the middle
+= of them
+=
+= Every column is traced whatever raystep is, since what the player can
+= see mustn't depend on how far behind the frame budget the view is.
+= Tracing is the cheap part; the scaled posts are what raystep saves.
+=
+= With markonly set the walls aren't drawn, only spotvis is marked
+=
+====================
+*/
+
+void AsmRefresh (void)
+{
+	ray_t	rays[RAYPACKET];
+	int		x,l,lanes,mid;
+
+	for (x = 0; x < viewwidth; x += lanes)
+	{
+		for (lanes = 0; lanes < RAYPACKET && x+lanes < viewwidth; lanes++)
+			StartRay (&rays[lanes],x+lanes);
+
+		TracePacket (rays,lanes);
+
+		for (l = 0; l < lanes; l++)
+		{
+			pixx = (x+l) - (x+l)%raystep;		// the first column of its group
+			mid = pixx + raystep/2;
+			if (mid >= viewwidth)
+				mid = viewwidth-1;
+			if (x+l == mid)
+				HitRay (&rays[l]);
 		}
 	}
 }
@@ -1389,33 +2302,48 @@ passhoriz:
 /*
 ====================
 =
-= WallRefresh
+= CalcViewVariables
 =
 ====================
 */
 
-void WallRefresh (void)
+void CalcViewVariables (void)
 {
-//
-// set up variables for this view
-//
 	viewangle = player->angle;
 	midangle = viewangle*(FINEANGLES/ANGLES);
 	viewsin = sintable[viewangle];
 	viewcos = costable[viewangle];
-	viewx = player->x - FixedByFrac(focallength,viewcos);
-	viewy = player->y + FixedByFrac(focallength,viewsin);
+	viewx = HOT(player)->x - FixedByFrac(focallength,viewcos);
+	viewy = HOT(player)->y + FixedByFrac(focallength,viewsin);
 
 	focaltx = viewx>>TILESHIFT;
 	focalty = viewy>>TILESHIFT;
 
-	viewtx = player->x >> TILESHIFT;
-	viewty = player->y >> TILESHIFT;
+	viewtx = HOT(player)->x >> TILESHIFT;
+	viewty = HOT(player)->y >> TILESHIFT;
 
 	xpartialdown = viewx&(TILEGLOBAL-1);
 	xpartialup = TILEGLOBAL-xpartialdown;
 	ypartialdown = viewy&(TILEGLOBAL-1);
 	ypartialup = TILEGLOBAL-ypartialdown;
+}
+
+//==========================================================================
+
+/*
+====================
+=
+= WallRefresh
+=
+====================
+*/
+
+void WallRefresh (void)
+{
+//
+// set up variables for this view
+//
+	CalcViewVariables ();
 
 	lastside = -1;			// the first pixel is on a new wall
 	AsmRefresh ();
@@ -1427,12 +2355,14 @@ void WallRefresh (void)
 /*
 ========================
 =
-= ThreeDRefresh
+= RenderView
+=
+= Draws the view into the screen buffer at screenofs without showing it
 =
 ========================
 */
 
-void	ThreeDRefresh (void)
+void	RenderView (void)
 {
 //
 // clear out the traced array
@@ -1440,29 +2370,451 @@ void	ThreeDRefresh (void)
 	memset(spotvis, 0, sizeof(spotvis));
 
 //
-// follow the walls from there to the right, drawing as we go
+// follow the walls from there to the right, drawing as we go, with the
+// floor and ceiling filled in around each post
 //
-	VGAClearScreen ();
-
+	SetPlaneColors ();
 	WallRefresh ();
+	if (textureplanes)
+		DrawPlaneRows (0,viewheight/2);
+	FindVisibleObjects ();
 
 //
 // draw all the scaled images
 //
 	DrawScaleds();			// draw scaled stuff
 	DrawPlayerWeapon ();	// draw player's hands
+}
+
+
+/*
+========================
+=
+= RenderColumns
+=
+= RenderView into this thread's column buffer, where every wall post and
+= sprite line is a run of consecutive bytes, then turned the right way
+= into dest, rows of pitch bytes, through lut if it's set.  The turning
+= is done in 8*8 blocks so both sides stay in cache, with NEON a whole
+= block at a time (TurnBlock).
+=
+========================
+*/
+
+#define TURNBLOCK	8
+
+#ifdef __ARM_NEON
+/*
+========================
+=
+= TurnBlock
+=
+= Turns the 8*8 block of columns at src into the rows at dest: eight
+= columns are loaded as vectors, and transposing pairs of bytes, then
+= of halfwords, then of words leaves each vector holding one row
+=
+========================
+*/
+
+static void TurnBlock (byte *dest, int pitch, const byte *src, const byte *lut)
+{
+	uint8x8x2_t		b01,b23,b45,b67;
+	uint16x4x2_t	h02,h13,h46,h57;
+	uint32x2x2_t	w04,w15,w26,w37;
+	uint8x8_t		rows[TURNBLOCK];
+	int				x,y;
+
+	b01 = vtrn_u8 (vld1_u8(src),vld1_u8(src+viewheight));
+	b23 = vtrn_u8 (vld1_u8(src+2*viewheight),vld1_u8(src+3*viewheight));
+	b45 = vtrn_u8 (vld1_u8(src+4*viewheight),vld1_u8(src+5*viewheight));
+	b67 = vtrn_u8 (vld1_u8(src+6*viewheight),vld1_u8(src+7*viewheight));
+
+	h02 = vtrn_u16 (vreinterpret_u16_u8(b01.val[0]),vreinterpret_u16_u8(b23.val[0]));
+	h13 = vtrn_u16 (vreinterpret_u16_u8(b01.val[1]),vreinterpret_u16_u8(b23.val[1]));
+	h46 = vtrn_u16 (vreinterpret_u16_u8(b45.val[0]),vreinterpret_u16_u8(b67.val[0]));
+	h57 = vtrn_u16 (vreinterpret_u16_u8(b45.val[1]),vreinterpret_u16_u8(b67.val[1]));
+
+	w04 = vtrn_u32 (vreinterpret_u32_u16(h02.val[0]),vreinterpret_u32_u16(h46.val[0]));
+	w15 = vtrn_u32 (vreinterpret_u32_u16(h13.val[0]),vreinterpret_u32_u16(h57.val[0]));
+	w26 = vtrn_u32 (vreinterpret_u32_u16(h02.val[1]),vreinterpret_u32_u16(h46.val[1]));
+	w37 = vtrn_u32 (vreinterpret_u32_u16(h13.val[1]),vreinterpret_u32_u16(h57.val[1]));
+
+	rows[0] = vreinterpret_u8_u32 (w04.val[0]);
+	rows[1] = vreinterpret_u8_u32 (w15.val[0]);
+	rows[2] = vreinterpret_u8_u32 (w26.val[0]);
+	rows[3] = vreinterpret_u8_u32 (w37.val[0]);
+	rows[4] = vreinterpret_u8_u32 (w04.val[1]);
+	rows[5] = vreinterpret_u8_u32 (w15.val[1]);
+	rows[6] = vreinterpret_u8_u32 (w26.val[1]);
+	rows[7] = vreinterpret_u8_u32 (w37.val[1]);
+
+	for (y = 0; y < TURNBLOCK; y++, dest += pitch)
+	{
+		vst1_u8 (dest,rows[y]);
+		if (lut)
+			for (x = 0; x < TURNBLOCK; x++)
+				dest[x] = lut[dest[x]];
+	}
+}
+#endif
+
+void	RenderColumns (byte *dest, int pitch, const byte *lut)
+{
+	int		x0,y0,x,y,xe,ye;
+	byte	*src,*row;
+
+	viewcolumns = viewcolumnbuf;
+	RenderView ();
+	viewcolumns = NULL;
+
+	for (y0 = 0; y0 < viewheight; y0 += TURNBLOCK)
+	{
+		ye = y0+TURNBLOCK < viewheight ? y0+TURNBLOCK : viewheight;
+		for (x0 = 0; x0 < viewwidth; x0 += TURNBLOCK)
+		{
+			xe = x0+TURNBLOCK < viewwidth ? x0+TURNBLOCK : viewwidth;
+#ifdef __ARM_NEON
+			if (xe-x0 == TURNBLOCK && ye-y0 == TURNBLOCK)
+			{
+				TurnBlock (dest+y0*pitch+x0,pitch,
+					viewcolumnbuf+x0*viewheight+y0,lut);
+				continue;
+			}
+#endif
+			for (y = y0; y < ye; y++)
+			{
+				src = viewcolumnbuf + y;
+				row = dest + y*pitch;
+				if (lut)
+					for (x = x0; x < xe; x++)
+						row[x] = lut[src[x*viewheight]];
+				else
+					for (x = x0; x < xe; x++)
+						row[x] = src[x*viewheight];
+			}
+		}
+	}
+}
+
+
+/*
+=============================================================================
+
+						  FRAME REUSE
+
+ThreeDRefresh keeps what went into the last view it drew.  When the player,
+the map, the doors, the pushwall, the statics, the actors and the weapon
+are all just as they were, the view it would draw is the one it drew, so
+that is copied back instead.  That also stands for the game side of the
+refresh: spotvis, FL_VISABLE and the projected actors are left from then.
+
+=============================================================================
+*/
+
+typedef struct
+{
+	gameinst_t	*inst;
+	fixed		x,y;
+	int			angle;
+	int			width,height;
+	unsigned	ofs;
+	int			episode,mapon;
+	int			health,ammo,keys,lives;
+	int			bestweapon,weapon,weaponframe;
+	boolean		demo,planes;
+	int			raystep;
+	unsigned	pushpos;
+	int			numactors,numstatics,numdoors;
+} viewkey_t;
+
+typedef struct
+{
+	byte		slot;
+	activetype	active;
+	statetype	*state;
+	byte		flags;
+	dirtype		dir;
+	fixed		x,y;
+	int			angle;
+} actorkey_t;
+
+static boolean		keyvalid;
+static viewkey_t	lastkey;
+static byte			keytiles[MAPSIZE][MAPSIZE];
+static unsigned		keydoors[MAXDOORS];
+static statobj_t	keystatics[MAXSTATS];
+static actorkey_t	keyactors[MAXACTORS];
+static byte			lastview[MAXVIEWWIDTH*(200-STATUSLINES)];
+
+
+/*
+========================
+=
+= BuildViewKey
+=
+========================
+*/
+
+static void BuildViewKey (viewkey_t *key)
+{
+	memset (key,0,sizeof(*key));		// so the padding compares too
+
+	key->inst = gameinst;
+	key->x = HOT(player)->x;
+	key->y = HOT(player)->y;
+	key->angle = player->angle;
+	key->width = viewwidth;
+	key->height = viewheight;
+	key->ofs = screenofs;
+	key->episode = gamestate.episode;
+	key->mapon = gamestate.mapon;
+	key->health = gamestate.health;
+	key->ammo = gamestate.ammo;
+	key->keys = gamestate.keys;
+	key->lives = gamestate.lives;
+	key->bestweapon = gamestate.bestweapon;
+	key->weapon = gamestate.weapon;
+	key->weaponframe = gamestate.weaponframe;
+	key->demo = demorecord || demoplayback;
+	key->planes = textureplanes;
+	key->raystep = raystep;
+	key->pushpos = pwallpos;
+	key->numactors = objcount;
+	key->numstatics = laststatobj-statobjlist;
+	key->numdoors = lastdoorobj-doorobjlist;
+}
+
+
+/*
+========================
+=
+= ActorKey
+=
+========================
+*/
+
+static void ActorKey (actorkey_t *key, int i)
+{
+	objtype	*ob;
+
+	memset (key,0,sizeof(*key));		// so the padding compares too
+
+	ob = ORDERACTOR(i);
+	key->slot = objorder[i];
+	key->active = ob->active;
+	key->state = HOT(ob)->state;
+	key->flags = ob->flags;
+	key->dir = ob->dir;
+	key->x = HOT(ob)->x;
+	key->y = HOT(ob)->y;
+	key->angle = ob->angle;
+}
+
+
+/*
+========================
+=
+= ViewChanged
+=
+= False when the view would come out the same as the last one drawn
+=
+========================
+*/
+
+static boolean ViewChanged (void)
+{
+	viewkey_t	key;
+	actorkey_t	actor;
+	int			i;
+
+	if (!keyvalid || gamestate.victoryflag)	// the deathcam blinks
+		return true;
+
+	BuildViewKey (&key);
+	if (memcmp (&key,&lastkey,sizeof(key))
+		|| memcmp (keytiles,tilemap,sizeof(keytiles))
+		|| memcmp (keydoors,doorposition,key.numdoors*sizeof(keydoors[0]))
+		|| memcmp (keystatics,statobjlist,key.numstatics*sizeof(statobj_t)))
+		return true;
+
+	for (i=1;i<objcount;i++)
+	{
+		ActorKey (&actor,i);
+		if (memcmp (&actor,&keyactors[i],sizeof(actor)))
+			return true;
+	}
+
+	return false;
+}
+
+
+/*
+========================
+=
+= SaveView
+=
+= Notes what went into the view just drawn, and the view itself
+=
+========================
+*/
+
+static void SaveView (void)
+{
+	int		i,y;
+
+	BuildViewKey (&lastkey);
+	memcpy (keytiles,tilemap,sizeof(keytiles));
+	memcpy (keydoors,doorposition,lastkey.numdoors*sizeof(keydoors[0]));
+	memcpy (keystatics,statobjlist,lastkey.numstatics*sizeof(statobj_t));
+	for (i=1;i<objcount;i++)
+		ActorKey (&keyactors[i],i);
+
+	for (y=0;y<viewheight;y++)
+		memcpy (lastview+y*viewwidth,sdl_framebuffer+screenofs+y*320,viewwidth);
+	keyvalid = true;
+}
+
+
+/*
+========================
+=
+= RestoreView
+=
+= Puts the last view back, over anything drawn on it since
+=
+========================
+*/
+
+static void RestoreView (void)
+{
+	int		y;
+
+	for (y=0;y<viewheight;y++)
+		memcpy (sdl_framebuffer+screenofs+y*320,lastview+y*viewwidth,viewwidth);
+}
+
+
+/*
+=============================================================================
+
+						  FRAME BUDGET
+
+With -framebudget set, ThreeDRefresh times every view it draws and trades
+horizontal resolution for time when the view runs over: raystep columns
+are drawn as one scaled post, the old wide post idea of the wall
+refresh, while the sprites, the weapon and the status bar stay at full
+resolution.  Nothing about the projection changes, so the scalers and
+view tables are left alone.  A view over budget coarsens at once, and
+it only gets finer again after running well under budget for a while,
+so a busy room costs a few soft frames instead of a dropped one.
+
+What the rays see decides what the actors see, so every column is still
+traced, whatever raystep the walls are drawn with.  Demos are drawn at
+full resolution as well.
+
+=============================================================================
+*/
+
+#define MAXRAYSTEP		4
+#define CALMFRAMES		35			// half a second at full speed
+
+long			framebudget;			// microseconds a view may take, 0 is off
+static long		renderavg;				// running average, microseconds
+static int		calmframes;
+
+
+/*
+========================
+=
+= BudgetFrame
+=
+= Picks the raystep for the next view from how long this one took to
+= draw, or with usec -1 for a view that was reused without drawing
+=
+========================
+*/
+
+static void BudgetFrame (long usec)
+{
+	if (!framebudget || demorecord || demoplayback)
+	{
+		raystep = 1;
+		return;
+	}
+
+	if (usec >= 0)
+	{
+		renderavg += (usec-renderavg)/8;
+
+		if (usec > framebudget && raystep < MAXRAYSTEP)
+		{
+			raystep++;
+			renderavg = renderavg*(raystep-1)/raystep;
+			calmframes = 0;
+			return;
+		}
+	}
 
 //
-// show screen and time last cycle
+// the cost at the next finer step, taking it to go with the posts
+//
+	if (raystep > 1 && renderavg*raystep/(raystep-1) < framebudget*3/4)
+	{
+		if (++calmframes >= CALMFRAMES)
+		{
+			raystep--;
+			renderavg = renderavg*(raystep+1)/raystep;
+			calmframes = 0;
+		}
+	}
+	else
+		calmframes = 0;
+}
+
+
+/*
+========================
+=
+= ThreeDRefresh
+=
+========================
+*/
+
+void	ThreeDRefresh (void)
+{
+	Uint64	start;
+
+	if (!ViewChanged ())
+	{
+		RestoreView ();
+		BudgetFrame (-1);
+	}
+	else
+	{
+		start = SDL_GetPerformanceCounter ();
+		if (columnrender)
+			RenderColumns (sdl_framebuffer+screenofs,320,NULL);
+		else
+			RenderView ();
+		SaveView ();
+		BudgetFrame ((long)((SDL_GetPerformanceCounter ()-start)*1000000
+			/SDL_GetPerformanceFrequency ()));
+	}
+
+//
+// the fizzle and a fade in run over the live view while play goes on
 //
 	if (fizzlein)
 	{
-		FizzleFade(bufferofs,displayofs+screenofs,viewwidth,viewheight,20,false);
+		FizzleBegin (displayofs+screenofs,viewwidth,viewheight,20);
 		fizzlein = false;
-
-		lasttimecount = TimeCount = 0;		// don't make a big tic count
 	}
+	FizzleFrame ();
+	VL_FadeFrame ();
 
+//
+// show screen and time last cycle
+//
 	VW_UpdateScreen();
 
 	frameon++;
@@ -1470,4 +2822,96 @@ void	ThreeDRefresh (void)
 }
 
 
+/*
+========================
+=
+= SimRefresh
+=
+= Stands in for ThreeDRefresh when simonly is set.  The view is traced
+= so spotvis matches a drawn frame, and the game side of the refresh runs,
+= but nothing is drawn or presented.
+=
+========================
+*/
+
+void	SimRefresh (void)
+{
+	memset(spotvis, 0, sizeof(spotvis));
+
+	CalcViewVariables ();
+	markonly = true;
+	AsmRefresh ();
+	markonly = false;
+	FindVisibleObjects ();
+
+	if (fizzlein)
+	{
+		fizzlein = false;
+		lasttimecount = 0;		// TimeCount is the shared clock, leave it be
+	}
+
+	frameon++;
+}
+
+
+/*
+========================
+=
+= AuxMap
+=
+= Fills map, MAPSIZE*MAPSIZE bytes in tilemap order, with AUXMAP_ bits
+= for what the last refresh saw.  Either refresh leaves spotvis, wallid and
+= FL_VISABLE behind, so this costs no tracing of its own.
+=
+========================
+*/
+
+void AuxMap (byte *map)
+{
+	int			i;
+	unsigned	spot;
+	byte		*vis,*tile;
+	statobj_t	*statptr;
+	doorobj_t	*door;
+	objtype		*obj;
+
+	vis = &spotvis[0][0];
+	tile = &tilemap[0][0];
+	for (spot=0;spot<MAPSIZE*MAPSIZE;spot++)
+	{
+		if (!vis[spot])
+			map[spot] = 0;
+		else if (tile[spot] & 0x80)
+			map[spot] = AUXMAP_SEEN | AUXMAP_DOOR;
+		else
+			map[spot] = AUXMAP_SEEN;
+	}
+
+	for (i=0;i<viewwidth;i++)
+	{
+		if ((wallid[i] & 0xf000) == AUXID_DOOR)
+		{
+			door = &doorobjlist[wallid[i] & 0xfff];
+			map[(door->tilex<<6)+door->tiley] |= AUXMAP_DOOR;
+		}
+		else
+			map[wallid[i] & 0xfff] |= AUXMAP_WALL;
+	}
+
+	for (statptr = &statobjlist[0] ; statptr !=laststatobj ; statptr++)
+		if (statptr->shapenum != -1 && statptr->flags & FL_BONUS
+			&& *statptr->visspot)
+			map[(statptr->tilex<<6)+statptr->tiley] |= AUXMAP_BONUS;
+
+	for (i=1;i<objcount;i++)
+	{
+		obj = ORDERACTOR(i);
+		if ((obj->flags & (FL_SHOOTABLE|FL_VISABLE)) == (FL_SHOOTABLE|FL_VISABLE))
+			map[(HOT(obj)->tilex<<6)+HOT(obj)->tiley] |= AUXMAP_ACTOR;
+	}
+
+	map[(HOT(player)->tilex<<6)+HOT(player)->tiley] |= AUXMAP_PLAYER;
+}
+
+
 //===========================================================================
@@ -0,0 +1,232 @@
+// WL_FORK.C
+
+#include "wl_def.h"
+#include "wl_lib.h"
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+
+#define REQUESTTIMEOUT	250			// ms the server waits for a request
+
+/*
+=============================================================================
+
+							 FORK SERVER
+
+W3D_ForkServer turns the calling process into a server for new games.  It
+loads every page of the page file and then waits on a Unix socket.  Each
+connection asks for a level with a w3d_forkrequest.  The server sets up
+that level's template if it doesn't have it yet, then forks.  The child
+already has everything loaded, shares it copy-on-write with the server,
+and plays the game over the connection:
+
+	child sends		w3d_forkreply
+	client sends	w3d_forkstep
+	child sends		w3d_status, then the frame if the step rendered
+	...
+	client closes the connection and the child exits
+
+fork only copies the calling thread, and the child goes on to allocate,
+so the server shuts down the sound manager's timer thread before it
+serves anything.  The level template threads are all joined before
+W3D_LoadEpisode returns, which leaves the server single threaded when it
+forks.  TimeCount stops with the timer.  Nothing under simonly reads it:
+instances count their own tics, and the death cam skips its waits and
+blinks on the game's clock.
+
+The server reads each request itself, since it has to build the level's
+template before forking, but only waits REQUESTTIMEOUT ms for it, so a
+client that connects and stalls can't hold up everyone behind it.
+
+=============================================================================
+*/
+
+/*
+===================
+=
+= ReadFull / WriteFull
+=
+===================
+*/
+
+static boolean ReadFull (int fd, void *buffer, size_t length)
+{
+	byte	*p;
+	ssize_t	got;
+
+	p = buffer;
+	while (length)
+	{
+		got = read (fd,p,length);
+		if (got <= 0)
+		{
+			if (got < 0 && errno == EINTR)
+				continue;
+			return false;
+		}
+		p += got;
+		length -= got;
+	}
+	return true;
+}
+
+
+static boolean WriteFull (int fd, const void *buffer, size_t length)
+{
+	const byte	*p;
+	ssize_t		put;
+
+	p = buffer;
+	while (length)
+	{
+		put = write (fd,p,length);
+		if (put <= 0)
+		{
+			if (put < 0 && errno == EINTR)
+				continue;
+			return false;
+		}
+		p += put;
+		length -= put;
+	}
+	return true;
+}
+
+
+/*
+===================
+=
+= SetReadTimeout
+=
+= 0 waits forever
+=
+===================
+*/
+
+static void SetReadTimeout (int fd, int ms)
+{
+	struct timeval	tv;
+
+	tv.tv_sec = ms/1000;
+	tv.tv_usec = (ms%1000)*1000;
+	setsockopt (fd,SOL_SOCKET,SO_RCVTIMEO,&tv,sizeof(tv));
+}
+
+
+/*
+===================
+=
+= ServeGame
+=
+= Runs in the child, never returns
+=
+===================
+*/
+
+static void ServeGame (int fd, w3d_forkrequest *req)
+{
+	w3d_instance	*inst;
+	w3d_forkreply	reply;
+	w3d_forkstep	step;
+	w3d_status		status;
+	const unsigned char	*frame;
+
+	SetReadTimeout (fd,0);			// the client steps at its own pace
+
+	inst = W3D_Create (req->episode,req->map,req->difficulty);
+	frame = W3D_Frame (inst,&reply.width,&reply.height);
+	reply.pid = getpid ();
+
+	if (!WriteFull (fd,&reply,sizeof(reply)))
+		_exit (1);
+
+	while (ReadFull (fd,&step,sizeof(step)))
+	{
+		if (step.reset)
+			W3D_Reset (inst);
+
+		W3D_Step (inst,&step.input,step.ntics,step.render);
+		W3D_GetStatus (inst,&status);
+
+		if (!WriteFull (fd,&status,sizeof(status)))
+			break;
+		if (step.render
+			&& !WriteFull (fd,frame,W3D_FrameSize (inst)))
+			break;
+	}
+
+	_exit (0);
+}
+
+
+/*
+===================
+=
+= W3D_ForkServer
+=
+= Only returns if the socket can't be set up
+=
+===================
+*/
+
+int W3D_ForkServer (const char *path)
+{
+	struct sockaddr_un	addr;
+	w3d_forkrequest		req;
+	int					listenfd,fd;
+	pid_t				pid;
+
+	if (strlen (path) >= sizeof(addr.sun_path))
+		return -1;
+
+	listenfd = socket (AF_UNIX,SOCK_STREAM,0);
+	if (listenfd == -1)
+		return -1;
+
+	memset (&addr,0,sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy (addr.sun_path,path);
+	unlink (path);
+
+	if (bind (listenfd,(struct sockaddr *)&addr,sizeof(addr)) == -1
+		|| listen (listenfd,64) == -1)
+	{
+		close (listenfd);
+		return -1;
+	}
+
+	signal (SIGCHLD,SIG_IGN);		// nobody waits for the children
+	signal (SIGPIPE,SIG_IGN);		// a dropped client is just a failed write
+
+	SD_Shutdown ();
+	SDL_QuitSubSystem (SDL_INIT_TIMER);	// joins SDL's timer thread
+
+	PM_Preload (NULL);
+
+	for (;;)
+	{
+		fd = accept (listenfd,NULL,NULL);
+		if (fd == -1)
+			continue;
+
+		SetReadTimeout (fd,REQUESTTIMEOUT);
+		if (!ReadFull (fd,&req,sizeof(req))
+			|| !W3D_LevelExists (req.episode,req.map,req.difficulty))
+		{
+			close (fd);
+			continue;
+		}
+
+		W3D_LoadEpisode (req.episode,req.difficulty);
+
+		pid = fork ();
+		if (!pid)
+		{
+			close (listenfd);
+			ServeGame (fd,&req);
+		}
+
+		close (fd);
+	}
+}
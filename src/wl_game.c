@@ -25,13 +25,8 @@
 =============================================================================
 */
 
-boolean		ingame,fizzlein;
+boolean		ingame;
 // latchpics defined in id_vh.c
-gametype	gamestate;
-
-long		spearx,speary;
-unsigned	spearangle;
-boolean		spearflag;
 
 //
 // ELEVATOR BACK MAPS - REMEMBER (-1)!!
@@ -648,11 +643,10 @@ void SetupGameLevel (void)
 //
 // load the level
 //
-	CA_CacheMap (gamestate.mapon+10*gamestate.episode);
-	mapon-=gamestate.episode*10;
+	CA_LoadMap (gamestate.mapon+10*gamestate.episode,mapsegs[0]);
 
-	mapwidth = mapheaderseg[mapon]->width;
-	mapheight = mapheaderseg[mapon]->height;
+	mapwidth = mapheaderseg[gamestate.mapon+10*gamestate.episode]->width;
+	mapheight = mapheaderseg[gamestate.mapon+10*gamestate.episode]->height;
 
 	if (mapwidth != 64 || mapheight != 64)
 		Quit ("Map not 64*64!");
@@ -909,17 +903,9 @@ void DrawPlayScreen (void)
 ==================
 */
 
-#define MAXDEMOSIZE	8192
-
-void StartDemoRecord (int levelnumber)
+void StartDemoRecord (void)
 {
-	MM_GetPtr (&demobuffer,MAXDEMOSIZE);
-	MM_SetLock (&demobuffer,true);
-	demoptr = (char far *)demobuffer;
-	lastdemoptr = demoptr+MAXDEMOSIZE;
-
-	*demoptr = levelnumber;
-	demoptr += 4;				// leave space for length
+	DemoStartRecord ();
 	demorecord = true;
 }
 
@@ -936,15 +922,10 @@ char	demoname[13] = "DEMO?.";
 
 void FinishDemoRecord (void)
 {
-	long	length,level;
+	long	level;
 
 	demorecord = false;
 
-	length = demoptr - (char far *)demobuffer;
-
-	demoptr = ((char far *)demobuffer)+1;
-	*(uint16_t *)demoptr = (uint16_t)length;  // demo format stores 16-bit length
-
 	CenterWindow(24,3);
 	PrintY+=6;
 	US_Print(" Demo number (0-9):");
@@ -956,12 +937,12 @@ void FinishDemoRecord (void)
 		if (level>=0 && level<=9)
 		{
 			demoname[4] = '0'+level;
-			CA_WriteFile (demoname,(void far *)demobuffer,length);
+			DemoFinishRecord (demoname);
+			return;
 		}
 	}
 
-
-	MM_FreePtr (&demobuffer);
+	DemoFinishRecord (NULL);
 }
 
 //==========================================================================
@@ -1005,7 +986,7 @@ void RecordDemo (void)
 	gamestate.mapon = level;
 #endif
 
-	StartDemoRecord (level);
+	StartDemoRecord ();
 
 	DrawPlayScreen ();
 	VW_FadeIn ();
@@ -1031,6 +1012,43 @@ void RecordDemo (void)
 
 //==========================================================================
 
+/*
+==================
+=
+= RunDemoLevel
+=
+= Plays the level set up by PlayDemo or PlayDemoFile
+=
+==================
+*/
+
+static void RunDemoLevel (void)
+{
+	VW_FadeOut ();
+
+	SETFONTCOLOR(0,15);
+	DrawPlayScreen ();
+	VW_FadeIn ();
+
+	startgame = false;
+	demoplayback = true;
+
+	SetupGameLevel ();
+	StartMusic ();
+	PM_CheckMainMem ();
+	fizzlein = true;
+
+	PlayLoop ();
+
+	demoplayback = false;
+	DemoStopPlayback ();
+
+	StopMusic ();
+	VW_FadeOut ();
+	ClearMemory ();
+}
+
+
 /*
 ==================
 =
@@ -1043,8 +1061,6 @@ void RecordDemo (void)
 
 void PlayDemo (int demonumber)
 {
-	int length;
-
 #ifdef DEMOSEXTERN
 // debug: load chunk
 #ifndef SPEARDEMO
@@ -1056,47 +1072,42 @@ void PlayDemo (int demonumber)
 	CA_CacheGrChunk(dems[demonumber]);
 	demoptr = grsegs[dems[demonumber]];
 	MM_SetLock (&grsegs[dems[demonumber]],true);
-#else
-	demoname[4] = '0'+demonumber;
-	CA_LoadFile (demoname,&demobuffer);
-	MM_SetLock (&demobuffer,true);
-	demoptr = (char far *)demobuffer;
-#endif
 
 	NewGame (1,0);
-	gamestate.mapon = *demoptr++;
+	DemoStartMemory ();
 	gamestate.difficulty = gd_hard;
-	length = *(uint16_t *)demoptr;  // demo format stores 16-bit length
-	demoptr += 2;
-	lastdemoptr = demoptr-4+length;
-
-	VW_FadeOut ();
-
-	SETFONTCOLOR(0,15);
-	DrawPlayScreen ();
-	VW_FadeIn ();
 
-	startgame = false;
-	demoplayback = true;
-
-	SetupGameLevel ();
-	StartMusic ();
-	PM_CheckMainMem ();
-	fizzlein = true;
+	RunDemoLevel ();
 
-	PlayLoop ();
-
-#ifdef DEMOSEXTERN
 	UNCACHEGRCHUNK(dems[demonumber]);
 #else
-	MM_FreePtr (&demobuffer);
+	demoname[4] = '0'+demonumber;
+	PlayDemoFile (demoname);
 #endif
+}
 
-	demoplayback = false;
 
-	StopMusic ();
-	VW_FadeOut ();
-	ClearMemory ();
+/*
+==================
+=
+= PlayDemoFile
+=
+= Plays a demo recorded by RecordDemo.  A desync against the recorded
+= state hashes quits with the tic it happened on.
+=
+==================
+*/
+
+void PlayDemoFile (char *name)
+{
+	NewGame (1,0);
+	if (!DemoStartPlayback (name))
+	{
+		sprintf (str,"PlayDemoFile: Can't play %.40s!",name);
+		Quit (str);
+	}
+
+	RunDemoLevel ();
 }
 
 //==========================================================================
@@ -1122,8 +1133,8 @@ void Died (void)
 //
 // swing around to face attacker
 //
-	dx = killerobj->x - player->x;
-	dy = player->y - killerobj->y;
+	dx = HOT(killerobj)->x - HOT(player)->x;
+	dy = HOT(player)->y - HOT(killerobj)->y;
 
 	fangle = atan2(dy,dx);			// returns -pi to pi
 	if (fangle<0)
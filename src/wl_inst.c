@@ -0,0 +1,217 @@
+// WL_INST.C
+
+#include "wl_def.h"
+
+/*
+=============================================================================
+
+						 GAME INSTANCES
+
+A gameinst_t holds everything a game in progress changes, so any number
+of games can run side by side in one process.  Each thread runs whichever
+instance gameinst points at; game code keeps using the old global names,
+which wl_def.h maps onto gameinst's fields.
+
+A thread that hasn't called GI_SetInstance runs the main instance, which
+is the one the normal game and its menus use.
+
+GI_Snapshot copies an instance into a buffer and GI_Restore copies it back,
+into the same instance or any other.  Pointers into the instance are kept
+in the copy as offsets from its start, so the copy doesn't care where it
+came from.  Pointers to states are left alone; the state tables are part
+of the program, so a snapshot is good for the program that took it.
+
+Still shared between instances: the caches and lookup tables, which are
+only written at startup or filled in once and then left alone (PM_GetPage,
+CA_CacheGrChunk), the screen, the sound manager, and demo record/playback.
+A refresh that draws (ThreeDRefresh) writes the one screen, so only one
+instance should draw at a time; SimRefresh draws nothing and any number
+can run at once.
+
+=============================================================================
+*/
+
+/*
+=============================================================================
+
+						 LOCAL VARIABLES
+
+=============================================================================
+*/
+
+static	gameinst_t	maininst;
+
+/*
+=============================================================================
+
+						 GLOBAL VARIABLES
+
+=============================================================================
+*/
+
+THREADLOCAL gameinst_t	*gameinst = &maininst;
+
+
+/*
+===================
+=
+= GI_NewInstance
+=
+= Returns a cleared instance, ready for NewGame and SetupGameLevel
+=
+===================
+*/
+
+gameinst_t *GI_NewInstance (void)
+{
+	gameinst_t	*gi;
+
+	gi = calloc (1,sizeof(*gi));
+	if (!gi)
+		Quit ("GI_NewInstance: Out of memory!");
+
+	return gi;
+}
+
+
+/*
+===================
+=
+= GI_FreeInstance
+=
+===================
+*/
+
+void GI_FreeInstance (gameinst_t *gi)
+{
+	if (gi == &maininst)
+		Quit ("GI_FreeInstance: Can't free the main instance!");
+
+	if (gameinst == gi)
+		gameinst = &maininst;
+
+	free (gi);
+}
+
+
+/*
+===================
+=
+= GI_SetInstance
+=
+= Makes gi the instance the calling thread runs, NULL for the main one
+=
+===================
+*/
+
+void GI_SetInstance (gameinst_t *gi)
+{
+	gameinst = gi ? gi : &maininst;
+}
+
+
+/*
+=============================================================================
+
+							SNAPSHOTS
+
+=============================================================================
+*/
+
+#define RELOCATE(p,delta)	if (p) (p) = (void *)((byte *)(p)+(delta))
+
+/*
+===================
+=
+= RelocateInstance
+=
+= Moves every pointer into the instance by delta bytes.  Slots that aren't
+= in use can hold stale links, they're moved too, which does no harm.
+=
+===================
+*/
+
+static void RelocateInstance (gameinst_t *gi, ptrdiff_t delta)
+{
+	gameinst_t	*oldinst;
+	objtype		*ob;
+	statobj_t	*stat;
+	int			i;
+
+	oldinst = gameinst;
+	gameinst = gi;
+
+	RELOCATE(new,delta);
+	RELOCATE(player,delta);
+	RELOCATE(killerobj,delta);
+	RELOCATE(LastAttacker,delta);
+
+	for (ob=&objlist[0];ob<&objlist[MAXACTORS];ob++)
+	{
+		RELOCATE(ob->schednext,delta);
+		RELOCATE(ob->schedprev,delta);
+	}
+
+	RELOCATE(gi->pendingactors.head,delta);
+	RELOCATE(gi->pendingactors.tail,delta);
+	RELOCATE(gi->runactors.head,delta);
+	RELOCATE(gi->runactors.tail,delta);
+	RELOCATE(gi->idleactors.head,delta);
+	RELOCATE(gi->idleactors.tail,delta);
+	for (i=0;i<NUMAREAS;i++)
+	{
+		RELOCATE(gi->areaactors[i].head,delta);
+		RELOCATE(gi->areaactors[i].tail,delta);
+	}
+	for (i=0;i<WHEELSIZE;i++)
+	{
+		RELOCATE(gi->actorwheel[i].head,delta);
+		RELOCATE(gi->actorwheel[i].tail,delta);
+	}
+	for (i=0;i<gi->numticking;i++)
+		RELOCATE(gi->tickorder[i],delta);
+
+	RELOCATE(laststatobj,delta);
+	RELOCATE(lastdoorobj,delta);
+
+	for (stat=&statobjlist[0];stat<&statobjlist[MAXSTATS];stat++)
+		RELOCATE(stat->visspot,delta);
+
+	gameinst = oldinst;
+}
+
+
+/*
+===================
+=
+= GI_Snapshot
+=
+= Copies gi into buffer, which takes GI_SNAPSHOTSIZE bytes aligned like
+= malloc's
+=
+===================
+*/
+
+void GI_Snapshot (gameinst_t *gi, void *buffer)
+{
+	memcpy (buffer,gi,sizeof(*gi));
+	RelocateInstance ((gameinst_t *)buffer,-(ptrdiff_t)gi);
+}
+
+
+/*
+===================
+=
+= GI_Restore
+=
+= Puts a snapshot into gi, which doesn't have to be the instance it came
+= from
+=
+===================
+*/
+
+void GI_Restore (gameinst_t *gi, const void *buffer)
+{
+	memcpy (gi,buffer,sizeof(*gi));
+	RelocateInstance (gi,(ptrdiff_t)gi);
+}
@@ -0,0 +1,774 @@
+// WL_LIB.C
+
+#include "wl_def.h"
+#include "wl_lib.h"
+
+/*
+=============================================================================
+
+						   LIBRARY INTERFACE
+
+Runs games for a caller instead of DemoLoop.  Each w3d_instance is a game
+instance (wl_inst.c) and a copy of its last drawn view.  Tics are run the
+way PlayLoop runs them under simonly, one at a time with tics=1, with the
+input from the caller in place of PollControls.  A W3D_Step of several
+tics repeats the input, and every tic still runs the game side of the
+refresh, so actors are woken and flagged FL_VISABLE just as they
+would over that many one tic steps.  Only the last tic is drawn and fills
+the automap.
+
+The game is set up with simonly, so a tic that doesn't render only traces
+the view (SimRefresh) and any number of instances can step at once, each
+on its own thread, drawing included: views are drawn straight into each
+instance's output, never into the shared screen.
+
+A level that ends isn't followed into the next one, W3D_Step just returns
+the playstate.
+
+Every level a game starts on is set up once, by SetupGameLevel into a
+scratch instance, and kept as a snapshot: its template.  W3D_Create and
+W3D_Reset restore the template instead of loading the level again.
+Templates are built on demand, or for a whole episode at once on one
+thread per map with W3D_LoadEpisode.  A template never changes once it's
+published, so finding one takes no lock.
+
+=============================================================================
+*/
+
+#define MAXEPISODES		(NUMMAPS/10)
+#define MAXDIFFICULTY	4
+
+struct w3d_instance_s
+{
+	gameinst_t	*gi;
+	int			episode,map,difficulty;	// level W3D_Reset goes back to
+	int			width,height;
+	byte		*frame;				// the instance's own frame
+	byte		*output;			// where frames go, frame or the caller's
+	int			format;				// W3D_INDEXED or W3D_GRAY
+
+	word		*depth,*ids;		// W3D_SetAux channels, NULL when off
+	byte		*automap;
+};
+
+/*
+=============================================================================
+
+						 LOCAL VARIABLES
+
+=============================================================================
+*/
+
+static	SDL_SpinLock	initspin;		// only guards creating initlock
+static	SDL_mutex	*initlock;			// W3D_Init and W3D_Shutdown
+static	int			users;				// W3D_Inits without a W3D_Shutdown
+static	SDL_atomic_t	liveinstances;	// W3D_Creates without a W3D_Destroy
+
+static	SDL_mutex	*sharedlock;		// PM_NextFrame
+static	SDL_mutex	*templatelock;		// building templates
+
+static	void		*leveltemplate[MAXEPISODES][10][MAXDIFFICULTY];
+
+static	byte		graymap[256];		// palette index to W3D_GRAY level
+static	uint32_t	argbpal[1+NUMREDSHIFTS+NUMWHITESHIFTS][256];	// W3D_ARGB
+
+
+/*
+===================
+=
+= BuildARGB
+=
+= A 0-63 VGA palette as 0xAARRGGBB
+=
+===================
+*/
+
+static void BuildARGB (uint32_t *argb, byte *palette)
+{
+	int		i;
+
+	for (i=0;i<256;i++)
+		argb[i] = 0xff000000
+			| (uint32_t)(palette[i*3]*255/63)<<16
+			| (uint32_t)(palette[i*3+1]*255/63)<<8
+			| (uint32_t)(palette[i*3+2]*255/63);
+}
+
+
+/*
+===================
+=
+= LockInit
+=
+= initlock is held while the data loads, which takes long enough that the
+= callers waiting on it should sleep rather than spin.  It's created on
+= first use and kept for the life of the process.
+=
+===================
+*/
+
+static void LockInit (void)
+{
+	SDL_AtomicLock (&initspin);
+	if (!initlock)
+		initlock = SDL_CreateMutex ();
+	SDL_AtomicUnlock (&initspin);
+
+	if (!initlock)
+		Quit ("LockInit: Can't create lock!");
+	SDL_LockMutex (initlock);
+}
+
+
+/*
+===================
+=
+= W3D_Init
+=
+= Only the first of any number of callers loads anything, the rest share
+= what it loaded
+=
+===================
+*/
+
+int W3D_Init (int argc, char **argv)
+{
+	int		i;
+
+	LockInit ();
+	if (users++)
+	{
+		SDL_UnlockMutex (initlock);
+		return 0;
+	}
+
+	_argc = argc;
+	_argv = argv;
+
+	vl_headless = true;
+	NoWait = true;
+
+	CheckForEpisodes ();
+	InitGame ();
+
+	simonly = true;
+
+//
+// with the sound off CA_LoadAllSounds has nothing to do, so SetupGameLevel
+// touches nothing shared and templates can be built side by side
+//
+	SD_SetSoundMode (sdm_Off);
+	SD_SetMusicMode (smm_Off);
+	CA_LoadAllSounds ();
+
+	for (i=0;i<256;i++)
+		graymap[i] = (gamepal[i*3]*77+gamepal[i*3+1]*150+gamepal[i*3+2]*29)
+			*255/(63*256);
+
+	BuildARGB (argbpal[0],gamepal);
+	for (i=0;i<NUMREDSHIFTS;i++)
+		BuildARGB (argbpal[1+i],redshifts[i]);
+	for (i=0;i<NUMWHITESHIFTS;i++)
+		BuildARGB (argbpal[1+NUMREDSHIFTS+i],whiteshifts[i]);
+
+	sharedlock = SDL_CreateMutex ();
+	templatelock = SDL_CreateMutex ();
+	if (!sharedlock || !templatelock)
+		Quit ("W3D_Init: Can't create lock!");
+
+	SDL_UnlockMutex (initlock);
+
+	return 0;
+}
+
+
+/*
+===================
+=
+= W3D_Shutdown
+=
+= The last caller frees everything
+=
+===================
+*/
+
+void W3D_Shutdown (void)
+{
+	int		e,m,d;
+
+	LockInit ();
+	if (!users || --users)
+	{
+		SDL_UnlockMutex (initlock);
+		return;
+	}
+
+	for (e=0;e<MAXEPISODES;e++)
+		for (m=0;m<10;m++)
+			for (d=0;d<MAXDIFFICULTY;d++)
+			{
+				free (leveltemplate[e][m][d]);
+				leveltemplate[e][m][d] = NULL;
+			}
+
+	if (sharedlock)
+	{
+		SDL_DestroyMutex (sharedlock);
+		sharedlock = NULL;
+	}
+	if (templatelock)
+	{
+		SDL_DestroyMutex (templatelock);
+		templatelock = NULL;
+	}
+
+	ShutdownId ();
+
+	SDL_UnlockMutex (initlock);
+}
+
+
+/*
+=============================================================================
+
+							LEVEL TEMPLATES
+
+=============================================================================
+*/
+
+/*
+===================
+=
+= BuildTemplate
+=
+= Sets the level up in a scratch instance and keeps a snapshot of it
+=
+===================
+*/
+
+static void *BuildTemplate (int episode, int map, int difficulty)
+{
+	gameinst_t	*oldinst,*gi;
+	void		*snap;
+
+	snap = malloc (GI_SNAPSHOTSIZE);
+	if (!snap)
+		Quit ("BuildTemplate: Out of memory!");
+
+	gi = GI_NewInstance ();
+	oldinst = gameinst;
+	GI_SetInstance (gi);
+
+	NewGame (difficulty,episode);
+	gamestate.mapon = map;
+	SetupGameLevel ();
+
+	ResetPlayLoop ();
+	rndindex = 0;				// so a run can be repeated
+	fizzlein = false;
+
+	GI_Snapshot (gi,snap);
+
+	GI_SetInstance (oldinst);
+	GI_FreeInstance (gi);
+
+	return snap;
+}
+
+
+/*
+===================
+=
+= W3D_LevelExists
+=
+===================
+*/
+
+int W3D_LevelExists (int episode, int map, int difficulty)
+{
+	return episode >= 0 && episode < MAXEPISODES && map >= 0 && map < 10
+		&& difficulty >= 0 && difficulty < MAXDIFFICULTY
+		&& mapheaderseg[episode*10+map];
+}
+
+
+/*
+===================
+=
+= CheckLevel
+=
+===================
+*/
+
+static void CheckLevel (int episode, int map, int difficulty)
+{
+	if (!W3D_LevelExists (episode,map,difficulty))
+		Quit ("W3D: No such level!");
+}
+
+
+/*
+===================
+=
+= LevelTemplate
+=
+===================
+*/
+
+static void *LevelTemplate (int episode, int map, int difficulty)
+{
+	void	**slot,*snap;
+
+	slot = &leveltemplate[episode][map][difficulty];
+
+	snap = SDL_AtomicGetPtr (slot);
+	if (snap)
+		return snap;
+
+	SDL_LockMutex (templatelock);
+	snap = SDL_AtomicGetPtr (slot);
+	if (!snap)
+	{
+		snap = BuildTemplate (episode,map,difficulty);
+		SDL_AtomicSetPtr (slot,snap);
+	}
+	SDL_UnlockMutex (templatelock);
+
+	return snap;
+}
+
+
+/*
+===================
+=
+= W3D_LoadEpisode
+=
+= Builds the templates for every map of an episode, a thread for each
+=
+===================
+*/
+
+typedef struct
+{
+	int			episode,map,difficulty;
+	void		*snap;
+	SDL_Thread	*thread;
+} templatejob_t;
+
+static int TemplateThread (void *data)
+{
+	templatejob_t	*job;
+
+	job = data;
+	job->snap = BuildTemplate (job->episode,job->map,job->difficulty);
+	return 0;
+}
+
+void W3D_LoadEpisode (int episode, int difficulty)
+{
+	templatejob_t	job[10];
+	int				map;
+
+	CheckLevel (episode,0,difficulty);
+
+	SDL_LockMutex (templatelock);
+
+	for (map=0;map<10;map++)
+	{
+		job[map].episode = episode;
+		job[map].map = map;
+		job[map].difficulty = difficulty;
+		job[map].snap = NULL;
+		job[map].thread = NULL;
+
+		if (leveltemplate[episode][map][difficulty]
+			|| !mapheaderseg[episode*10+map])
+			continue;
+
+		job[map].thread = SDL_CreateThread (TemplateThread,"w3dlevel",&job[map]);
+		if (!job[map].thread)
+			TemplateThread (&job[map]);		// do it here instead
+	}
+
+	for (map=0;map<10;map++)
+	{
+		if (job[map].thread)
+			SDL_WaitThread (job[map].thread,NULL);
+		if (job[map].snap)
+			SDL_AtomicSetPtr (&leveltemplate[episode][map][difficulty],
+				job[map].snap);
+	}
+
+	SDL_UnlockMutex (templatelock);
+}
+
+
+/*
+=============================================================================
+
+							INSTANCES
+
+=============================================================================
+*/
+
+/*
+===================
+=
+= W3D_Create
+=
+===================
+*/
+
+w3d_instance *W3D_Create (int episode, int map, int difficulty)
+{
+	w3d_instance	*inst;
+
+	CheckLevel (episode,map,difficulty);
+
+	inst = calloc (1,sizeof(*inst));
+	if (!inst)
+		Quit ("W3D_Create: Out of memory!");
+
+	inst->width = viewwidth;
+	inst->height = viewheight;
+	inst->frame = calloc (viewwidth*viewheight,sizeof(uint32_t));	// any format
+	if (!inst->frame)
+		Quit ("W3D_Create: Out of memory!");
+	inst->output = inst->frame;
+	inst->format = W3D_INDEXED;
+
+	inst->episode = episode;
+	inst->map = map;
+	inst->difficulty = difficulty;
+
+	inst->gi = GI_NewInstance ();
+	W3D_Reset (inst);
+
+	SDL_AtomicAdd (&liveinstances,1);
+	return inst;
+}
+
+
+/*
+===================
+=
+= W3D_Reset
+=
+= Back to the start of the level the instance was created on
+=
+===================
+*/
+
+void W3D_Reset (w3d_instance *inst)
+{
+	GI_Restore (inst->gi,LevelTemplate (inst->episode,inst->map,
+		inst->difficulty));
+}
+
+
+/*
+===================
+=
+= W3D_Destroy
+=
+===================
+*/
+
+void W3D_Destroy (w3d_instance *inst)
+{
+	if (!inst)
+		return;
+
+	GI_FreeInstance (inst->gi);
+	free (inst->frame);
+	free (inst);
+
+	SDL_AtomicAdd (&liveinstances,-1);
+}
+
+
+/*
+===================
+=
+= DrawFrame
+=
+= Draws the view into the output without going near the shared screen.
+= W3D_ARGB frames are drawn straight into it through the palette of the
+= shift the game would be showing.  The others are drawn column-major
+= and turned into it, through graymap for W3D_GRAY, so the turning is
+= the only pass over the frame.
+=
+===================
+*/
+
+static void DrawFrame (w3d_instance *inst)
+{
+	int		shift;
+
+	auxdepth = inst->depth;
+	auxid = inst->ids;
+
+	if (inst->format == W3D_ARGB)
+	{
+		shift = PaletteShift ();
+		viewargb = (uint32_t *)inst->output;
+		viewpal = argbpal[shift < 0 ? NUMREDSHIFTS-shift : shift];
+
+		RenderView ();
+
+		viewargb = NULL;
+	}
+	else
+		RenderColumns (inst->output,inst->width,
+			inst->format == W3D_GRAY ? graymap : NULL);
+
+	auxdepth = auxid = NULL;
+
+	SDL_LockMutex (sharedlock);
+	PM_NextFrame ();
+	SDL_UnlockMutex (sharedlock);
+
+	frameon++;
+}
+
+
+/*
+===================
+=
+= W3D_Step
+=
+===================
+*/
+
+int W3D_Step (w3d_instance *inst, const w3d_input *input, int ntics,
+	int render)
+{
+	gameinst_t	*oldinst;
+	int			result;
+
+	//
+	// the frame was sized for the view the instance was created with,
+	// so don't run a tic that can't be drawn
+	//
+	if (render && (inst->width != viewwidth || inst->height != viewheight))
+		return W3D_ERROR;
+
+	oldinst = gameinst;
+	GI_SetInstance (inst->gi);
+
+	while (ntics-- > 0 && !playstate)
+	{
+		tics = 1;
+		lasttimecount += tics;
+
+		InjectControls (input->buttons,input->xmove,input->ymove);
+		ThinkTic ();
+
+	//
+	// every tic traces the view for the game side of the refresh; only
+	// the last one is drawn
+	//
+		if ((!ntics || playstate) && render)
+			DrawFrame (inst);
+		else
+			SimRefresh ();
+
+		if ((!ntics || playstate) && inst->automap)
+			AuxMap (inst->automap);
+
+		FinishTic ();
+	}
+
+	result = playstate;
+	GI_SetInstance (oldinst);
+
+	return result;
+}
+
+
+/*
+===================
+=
+= W3D_Frame
+=
+===================
+*/
+
+const unsigned char *W3D_Frame (w3d_instance *inst, int *width, int *height)
+{
+	*width = inst->width;
+	*height = inst->height;
+	return inst->output;
+}
+
+
+/*
+===================
+=
+= W3D_FrameSize
+=
+===================
+*/
+
+size_t W3D_FrameSize (w3d_instance *inst)
+{
+	if (inst->format == W3D_ARGB)
+		return (size_t)inst->width*inst->height*sizeof(uint32_t);
+
+	return (size_t)inst->width*inst->height;
+}
+
+
+/*
+===================
+=
+= W3D_SetOutput
+=
+===================
+*/
+
+void W3D_SetOutput (w3d_instance *inst, unsigned char *buffer, int format)
+{
+	inst->output = buffer ? buffer : inst->frame;
+	inst->format = format;
+}
+
+
+/*
+===================
+=
+= W3D_SetAux
+=
+===================
+*/
+
+void W3D_SetAux (w3d_instance *inst, unsigned short *depth,
+	unsigned short *ids, unsigned char *automap)
+{
+	inst->depth = depth;
+	inst->ids = ids;
+	inst->automap = automap;
+}
+
+
+/*
+===================
+=
+= W3D_SetView
+=
+= The view is drawn at its real size, the rays, posts and sprites are all
+= worked out for it by SetViewSize
+=
+===================
+*/
+
+int W3D_SetView (int width, int height)
+{
+	if (SDL_AtomicGet (&liveinstances))
+		return -1;				// their frames are the old size
+
+	if (width < 16 || width > MAXVIEWWIDTH || (width&15)
+		|| height < 2 || height > 200-STATUSLINES || (height&1))
+		return -1;
+
+	SetViewSize (width,height);
+	return 0;
+}
+
+
+/*
+===================
+=
+= W3D_Palette
+=
+===================
+*/
+
+const unsigned char *W3D_Palette (void)
+{
+	return gamepal;
+}
+
+
+/*
+===================
+=
+= W3D_GetStatus
+=
+===================
+*/
+
+void W3D_GetStatus (w3d_instance *inst, w3d_status *status)
+{
+	gameinst_t	*oldinst;
+
+	oldinst = gameinst;
+	GI_SetInstance (inst->gi);
+
+	status->state = playstate;
+	status->episode = gamestate.episode;
+	status->map = gamestate.mapon;
+	status->difficulty = gamestate.difficulty;
+
+	status->health = gamestate.health;
+	status->ammo = gamestate.ammo;
+	status->lives = gamestate.lives;
+	status->keys = gamestate.keys;
+	status->weapon = gamestate.weapon;
+	status->score = gamestate.score;
+	status->killcount = gamestate.killcount;
+	status->killtotal = gamestate.killtotal;
+	status->secretcount = gamestate.secretcount;
+	status->secrettotal = gamestate.secrettotal;
+	status->treasurecount = gamestate.treasurecount;
+	status->treasuretotal = gamestate.treasuretotal;
+	status->tics = gamestate.TimeCount;
+
+	status->x = HOT(player)->x;
+	status->y = HOT(player)->y;
+	status->angle = player->angle;
+
+	GI_SetInstance (oldinst);
+}
+
+
+/*
+===================
+=
+= W3D_SnapshotSize
+=
+===================
+*/
+
+size_t W3D_SnapshotSize (void)
+{
+	return GI_SNAPSHOTSIZE;
+}
+
+
+/*
+===================
+=
+= W3D_Snapshot
+=
+===================
+*/
+
+void W3D_Snapshot (w3d_instance *inst, void *buffer)
+{
+	GI_Snapshot (inst->gi,buffer);
+}
+
+
+/*
+===================
+=
+= W3D_Restore
+=
+===================
+*/
+
+void W3D_Restore (w3d_instance *inst, const void *buffer)
+{
+	GI_Restore (inst->gi,buffer);
+}
@@ -0,0 +1,265 @@
+// WL_LIB.H
+//
+// Public interface of libwolf3d, for programs that run the game themselves
+// instead of through DemoLoop.  Nothing here depends on the game headers.
+
+#ifndef __WL_LIB_H__
+#define __WL_LIB_H__
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct w3d_instance_s w3d_instance;
+
+//
+// w3d_input.buttons, the same bits PollControls packs into a demo record
+//
+#define W3D_ATTACK		0x01
+#define W3D_STRAFE		0x02
+#define W3D_RUN			0x04
+#define W3D_USE			0x08
+#define W3D_KNIFE		0x10
+#define W3D_PISTOL		0x20
+#define W3D_MACHINEGUN	0x40
+#define W3D_CHAINGUN	0x80
+
+//
+// input for one tic, what PollControls leaves in controlx and controly
+// divided by tics.  xmove turns (or strafes with W3D_STRAFE), ymove moves,
+// negative is left / forward.  The keyboard gives 35 walking and 70
+// running; anything past 100 either way is cut back to 100, as PollControls
+// does.
+//
+typedef struct
+{
+	unsigned char	buttons;
+	signed char		xmove,ymove;
+} w3d_input;
+
+//
+// W3D_Step's return and w3d_status.state, the game's playstate
+//
+#define W3D_PLAYING			0
+#define W3D_COMPLETED		1
+#define W3D_DIED			2
+#define W3D_VICTORIOUS		6
+#define W3D_SECRETLEVEL		9
+#define W3D_ERROR			-1			// nothing was run
+
+typedef struct
+{
+	int		state;
+	int		episode,map,difficulty;
+
+	int		health,ammo,lives,keys,weapon;
+	long	score;
+	int		killcount,killtotal;
+	int		secretcount,secrettotal;
+	int		treasurecount,treasuretotal;
+	long	tics;					// game tics since the level started
+
+	long	x,y;					// 16.16 fixed point tiles
+	int		angle;					// degrees, 0 is east
+} w3d_status;
+
+
+//
+// W3D_Init loads the data files from the current directory, with the
+// same command line parameters the game takes, and always returns 0: a
+// failure, such as missing data files or running out of memory, goes
+// through the game's Quit, which prints the error and exits the process.
+// Any number of users in a process can call it; the first loads the data,
+// the rest share it, and the W3D_Shutdown that matches the last W3D_Init
+// frees it.  Instances only add their own game state on top.
+//
+int		W3D_Init (int argc, char **argv);
+void	W3D_Shutdown (void);
+
+//
+// a new game on episode 0-5, map 0-9, difficulty 0-3.  W3D_LevelExists
+// says if the data files have that level; W3D_Create quits if they don't.
+//
+int				W3D_LevelExists (int episode, int map, int difficulty);
+w3d_instance	*W3D_Create (int episode, int map, int difficulty);
+void			W3D_Destroy (w3d_instance *inst);
+
+//
+// back to the start of the level the instance was created on
+//
+void			W3D_Reset (w3d_instance *inst);
+
+//
+// Sets up every map of an episode ahead of time, in parallel, so
+// W3D_Create and W3D_Reset on them are just a copy.  Without it each
+// level is set up the first time it's asked for.
+//
+void			W3D_LoadEpisode (int episode, int difficulty);
+
+//
+// Runs ntics tics with the same input and returns the playstate.  Stops
+// early if the level ends; the instance then has to be reset or destroyed.
+// Every tic traces the view for what the player can see and shoot at, so
+// a step of several tics plays the same as that many steps of one; only
+// the last tic is drawn, and only if render is set.  Returns
+// W3D_ERROR without running anything if render is set and the view isn't
+// the size the instance was created at.
+//
+int		W3D_Step (w3d_instance *inst, const w3d_input *input, int ntics,
+			int render);
+
+//
+// The size the view is drawn at, the game's own view size by default.
+// Smaller views such as 80*50 or 160*100 are traced with fewer rays and
+// drawn with fewer pixels, not scaled down afterwards.  The view tables
+// are shared by every instance, so it can only be called while there are
+// none: between W3D_Init and the first W3D_Create, or once every instance
+// has been destroyed.  width must be a multiple of 16 from 16 to 320 and
+// height even from 2 to 160.  Returns -1 for a size it can't do or while
+// any instance is live.
+//
+int		W3D_SetView (int width, int height);
+
+//
+// the view from the last W3D_Step that rendered: width*height pixels of
+// W3D_FrameSize bytes in all, rows one after the other
+//
+const unsigned char	*W3D_Frame (w3d_instance *inst, int *width, int *height);
+size_t				W3D_FrameSize (w3d_instance *inst);
+
+//
+// Frames are written straight to buffer, W3D_FrameSize bytes the caller
+// owns, or to the instance's own frame if buffer is NULL.  W3D_INDEXED
+// frames are palette indexes, W3D_GRAY frames are 0-255 luminance.
+// W3D_ARGB frames are 32 bit 0xAARRGGBB pixels in native byte order,
+// drawn in color as the walls and sprites are scaled, with the red and
+// white flashes the game would show; since they don't go through the
+// shared screen, instances on different threads draw them side by side.
+//
+#define W3D_INDEXED		0
+#define W3D_GRAY		1
+#define W3D_ARGB		2
+
+void	W3D_SetOutput (w3d_instance *inst, unsigned char *buffer, int format);
+
+//
+// Extra channels the refresh fills in as it goes, into buffers the caller
+// owns; NULL turns a channel off.  depth and ids are width*height, laid out
+// like the frame and written by steps that render.  automap is 64*64 bytes
+// in the game's own order, [tilex*64+tiley], written by every step.
+//
+// depth is the distance out from the view in 1/256 tiles, W3D_FAR for
+// floor and ceiling.  An id is a W3D_ID kind in the top bits and an index
+// in the low 12: the map spot of a wall, a door number, a static object's
+// index or an actor's slot.  Floor and ceiling are 0.
+//
+#define W3D_FAR			0xffff
+
+#define W3D_ID_WALL		0x1000
+#define W3D_ID_DOOR		0x2000
+#define W3D_ID_STATIC	0x3000
+#define W3D_ID_ACTOR	0x4000
+#define W3D_ID_WEAPON	0x5000			// the player's own weapon
+#define W3D_ID_KIND		0xf000
+#define W3D_ID_INDEX	0x0fff
+
+#define W3D_MAP_SEEN	0x01			// the view saw into the tile
+#define W3D_MAP_WALL	0x02			// the view stopped on its wall
+#define W3D_MAP_DOOR	0x04
+#define W3D_MAP_ACTOR	0x08			// an enemy the player can see
+#define W3D_MAP_BONUS	0x10			// a pickup in a seen tile
+#define W3D_MAP_PLAYER	0x20
+
+void	W3D_SetAux (w3d_instance *inst, unsigned short *depth,
+			unsigned short *ids, unsigned char *automap);
+
+//
+// 256 RGB triples of 0-63 VGA levels, for the indexes in W3D_Frame
+//
+const unsigned char	*W3D_Palette (void);
+
+void	W3D_GetStatus (w3d_instance *inst, w3d_status *status);
+
+
+//
+// Snapshots hold the whole game of an instance.  W3D_Restore puts one back
+// into any instance from this W3D_Init, not just the one it came from, so
+// a game can be branched.  The buffer is W3D_SnapshotSize bytes, aligned
+// as malloc aligns.
+//
+size_t	W3D_SnapshotSize (void);
+void	W3D_Snapshot (w3d_instance *inst, void *buffer);
+void	W3D_Restore (w3d_instance *inst, const void *buffer);
+
+
+//
+// Batches step many instances at once on a pool of threads, threads 0 for
+// one per CPU.  The instances must all come from this W3D_Init, have the
+// same output format and keep it, and stay alive while the batch does;
+// W3D_DestroyBatch doesn't destroy them.  Instances whose frames aren't
+// all the same size quit.
+//
+typedef struct w3d_batch_s w3d_batch;
+
+w3d_batch	*W3D_CreateBatch (w3d_instance **inst, int count, int threads);
+void		W3D_DestroyBatch (w3d_batch *batch);
+
+//
+// bytes of obs for each instance: a w3d_status, then its frame
+//
+size_t		W3D_BatchStride (w3d_batch *batch);
+
+//
+// Runs W3D_Step on every instance with inputs[i] and writes the
+// observations to obs, count*W3D_BatchStride bytes.  Frames are only
+// written when render is set.  Returns how many are still playing.
+//
+int			W3D_StepBatch (w3d_batch *batch, const w3d_input *inputs,
+				int ntics, int render, unsigned char *obs);
+
+//
+// instance steps per second over all W3D_StepBatch calls: each call is one
+// step of every instance in the batch, whatever ntics it was given
+//
+double		W3D_BatchRate (w3d_batch *batch);
+
+
+//
+// Fork server: W3D_ForkServer listens on a Unix socket at path and forks
+// an already loaded child for each connection, which then plays one game
+// over it.  The connection starts with a w3d_forkrequest, the child answers
+// with a w3d_forkreply, and then every w3d_forkstep is answered with a
+// w3d_status, followed by the frame when render is set.
+// Closing the connection ends the child.  Everything is in native byte
+// order, client and server are on the same machine.
+//
+// W3D_ForkServer only returns, with -1, if the socket can't be set up.
+//
+typedef struct
+{
+	int		episode,map,difficulty;
+} w3d_forkrequest;
+
+typedef struct
+{
+	int		pid;
+	int		width,height;
+} w3d_forkreply;
+
+typedef struct
+{
+	w3d_input	input;
+	int			ntics;
+	int			render;
+	int			reset;				// W3D_Reset before stepping
+} w3d_forkstep;
+
+int		W3D_ForkServer (const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -6,6 +6,7 @@
 #include <signal.h>
 #include <execinfo.h>
 
+#ifndef WOLFLIB
 static void crash_handler(int sig)
 {
 	void *bt[64];
@@ -14,6 +15,7 @@ static void crash_handler(int sig)
 	backtrace_symbols_fd(bt, n, 2);
 	_exit(1);
 }
+#endif
 
 
 extern void PG13(void);
@@ -325,6 +327,7 @@ boolean SaveTheGame(int file,int x,int y)
 {
 	long size,checksum;
 	objtype *ob,nullobj;
+	int i;
 
 
 	// Skip disk space check - not applicable on modern systems
@@ -332,6 +335,8 @@ boolean SaveTheGame(int file,int x,int y)
 	checksum = 0;
 
 
+	SyncActorTics ();
+
 	DiskFlopAnim(x,y);
 	CA_FarWrite (file,(void *)&gamestate,sizeof(gamestate));
 	checksum = DoChecksum((byte *)&gamestate,sizeof(gamestate),checksum);
@@ -355,10 +360,12 @@ boolean SaveTheGame(int file,int x,int y)
 	CA_FarWrite (file,(void *)areaconnect,sizeof(areaconnect));
 	CA_FarWrite (file,(void *)areabyplayer,sizeof(areabyplayer));
 
-	for (ob = player ; ob ; ob=ob->next)
+	for (i=0 ; i<objcount ; i++)
 	{
+	 ob = ORDERACTOR(i);
 	 DiskFlopAnim(x,y);
 	 CA_FarWrite (file,(void *)ob,sizeof(*ob));
+	 CA_FarWrite (file,(void *)HOT(ob),sizeof(objhot_t));
 	}
 	nullobj.active = ac_badobject;          // end of file marker
 	DiskFlopAnim(x,y);
@@ -414,6 +421,7 @@ boolean LoadTheGame(int file,int x,int y)
 {
 	long checksum,oldchecksum;
 	objtype *ob,nullobj;
+	objhot_t nullhot;
 
 
 	checksum = 0;
@@ -448,7 +456,10 @@ boolean LoadTheGame(int file,int x,int y)
 
 	InitActorList ();
 	DiskFlopAnim(x,y);
-	CA_FarRead (file,(void *)player,sizeof(*player));
+	CA_FarRead (file,(void *)&nullobj,sizeof(nullobj));
+	CA_FarRead (file,(void *)&nullhot,sizeof(nullhot));
+	memcpy (player,&nullobj,offsetof(objtype,seq));
+	*HOT(player) = nullhot;
 
 	while (1)
 	{
@@ -456,9 +467,11 @@ boolean LoadTheGame(int file,int x,int y)
 		CA_FarRead (file,(void *)&nullobj,sizeof(nullobj));
 		if (nullobj.active == ac_badobject)
 			break;
+		CA_FarRead (file,(void *)&nullhot,sizeof(nullhot));
 		GetNewActor ();
-	 // don't copy over the links
-		memcpy (new,&nullobj,sizeof(nullobj)-4);
+	 // don't copy over the scheduler links
+		memcpy (new,&nullobj,offsetof(objtype,seq));
+		*HOT(new) = nullhot;
 	}
 
 
@@ -796,6 +809,37 @@ boolean MS_CheckParm (char *check)
 	return false;
 }
 
+
+/*
+=================
+=
+= MS_ParmValue
+=
+= Returns the argument following check, or NULL
+=
+=================
+*/
+
+char *MS_ParmValue (char *check)
+{
+	int             i;
+	char    *parm;
+
+	for (i = 1;i<_argc-1;i++)
+	{
+		parm = _argv[i];
+
+		while ( !isalpha(*parm) )       // skip - / \ etc.. in front of parm
+			if (!*parm++)
+				break;                          // hit end of string without an alphanum
+
+		if ( !strcasecmp(check,parm) )
+			return _argv[i+1];
+	}
+
+	return NULL;
+}
+
 //===========================================================================
 
 /*
@@ -1096,16 +1140,22 @@ void InitGame (void)
 {
 	int                     i,x,y;
 	unsigned        *blockstart;
+	char    *parm;
 
 	if (MS_CheckParm ("virtual"))
 		virtualreality = true;
 	else
 		virtualreality = false;
 
+	simonly = MS_CheckParm ("simonly");
+	if (MS_CheckParm ("nodemohash"))
+		demohashtics = 0;
+
 	MM_Startup ();                  // so the signon screen can be freed
 
 	VW_Startup ();                  // must init SDL before SignonScreen touches framebuffer
-	SignonScreen ();
+	if (!vl_headless)
+		SignonScreen ();
 
 	IN_Startup ();
 	PM_Startup ();
@@ -1114,6 +1164,29 @@ void InitGame (void)
 	CA_Startup ();
 	US_Startup ();
 
+//
+// -framebudget is how many milliseconds the view may take to draw before
+// ThreeDRefresh starts sharing rays between columns
+//
+	if ( (parm = MS_ParmValue ("framebudget")) != NULL)
+		framebudget = atof (parm)*1000;
+
+//
+// -planes textures the floor and ceiling, with wall pages 0 and 1 unless
+// -ceilingpage and -floorpage say otherwise
+//
+	if (MS_CheckParm ("planes"))
+	{
+		textureplanes = true;
+		if ( (parm = MS_ParmValue ("ceilingpage")) != NULL)
+			ceilingpage = atoi (parm);
+		if ( (parm = MS_ParmValue ("floorpage")) != NULL)
+			floorpage = atoi (parm);
+		if (ceilingpage < 0 || ceilingpage >= PMSpriteStart
+			|| floorpage < 0 || floorpage >= PMSpriteStart)
+			Quit ("InitGame: -ceilingpage and -floorpage must be wall pages!");
+	}
+
 
 #ifndef SPEAR
 	if (mminfo.mainmem < 235000L)
@@ -1156,6 +1229,8 @@ void InitGame (void)
 //
 // HOLDING DOWN 'M' KEY?
 //
+	if (!vl_headless)
+	{
 #ifndef SPEARDEMO
 	if (Keyboard[sc_M])
 	  DoJukebox();
@@ -1166,6 +1241,7 @@ void InitGame (void)
 //
 	if (!virtualreality)
 		IntroScreen ();
+	}
 
 //
 // load in and lock down some basic chunks
@@ -1197,7 +1273,7 @@ close(profilehandle);
 // initialize variables
 //
 	InitRedShifts ();
-	if (!virtualreality)
+	if (!virtualreality && !vl_headless)
 		FinishSignon();
 
 	// Single framebuffer - no page flipping needed
@@ -1324,6 +1400,7 @@ void    DemoLoop (void)
 	int     i,level;
 	long nsize;
 	memptr	nullblock;
+	char	*demofile;
 
 //
 // check for launch from ted
@@ -1353,6 +1430,15 @@ void    DemoLoop (void)
 		Quit (NULL);
 	}
 
+//
+// check for a recorded demo to play back
+//
+	if ( (demofile = MS_ParmValue ("playdemo")) != NULL)
+	{
+		PlayDemoFile (demofile);
+		Quit (NULL);
+	}
+
 
 //
 // main game cycle
@@ -1493,6 +1579,7 @@ void    DemoLoop (void)
 
 char    *nosprtxt[] = {"nospr",nil};
 
+#ifndef WOLFLIB
 int main (int argc, char *argv[])
 {
 	int     i;
@@ -1522,6 +1609,11 @@ int main (int argc, char *argv[])
 
 	Patch386 ();
 
+	if (MS_CheckParm ("surface"))
+		vl_surfacepresent = true;	// CPU scaling into the window itself
+	if (MS_CheckParm ("columns"))
+		columnrender = true;		// draw the view column-major
+
 	InitGame ();
 
 	DemoLoop();
@@ -1530,3 +1622,4 @@ int main (int argc, char *argv[])
 
 	return 0;
 }
+#endif
@@ -24,29 +24,20 @@
 =============================================================================
 */
 
-boolean		madenoise;					// true when shooting or screaming
-
-exit_t		playstate;
-
 int			DebugOk;
 
-objtype 	objlist[MAXACTORS],*new,*obj,*player,*lastobj,
-			*objfreelist,*killerobj;
-
 unsigned	farmapylookup[MAPSIZE];
 byte		*nearmapylookup[MAPSIZE];
 
 boolean		singlestep,godmode,noclip;
 int			extravbls;
-
-byte		tilemap[MAPSIZE][MAPSIZE];	// wall values only
-byte		spotvis[MAPSIZE][MAPSIZE];
-objtype		*actorat[MAPSIZE][MAPSIZE];
+boolean		simonly;				// play without drawing or waiting
 
 //
 // replacing refresh manager
 //
-unsigned	mapwidth,mapheight,tics;
+unsigned	mapwidth,mapheight;
+THREADLOCAL unsigned	tics;			// tics since the last frame, set per step
 boolean		compatability;
 byte		*updateptr;
 unsigned	mapwidthtable[64];
@@ -67,18 +58,10 @@ int			buttonjoy[4]={bt_attack,bt_strafe,bt_use,bt_run};
 
 int			viewsize;
 
-boolean		buttonheld[NUMBUTTONS];
-
 boolean		demorecord,demoplayback;
 char		far *demoptr, far *lastdemoptr;
 memptr		demobuffer;
 
-//
-// curent user input
-//
-int			controlx,controly;		// range from -100 to 100 per tic
-boolean		buttonstate[NUMBUTTONS];
-
 
 
 //===========================================================================
@@ -463,7 +446,12 @@ void PollControls (void)
 //
 // get timing info for last frame
 //
-	if (demoplayback)
+	if (simonly)
+	{
+		lasttimecount += DEMOTICS;		// no clock, instances step at will
+		tics = DEMOTICS;
+	}
+	else if (demoplayback)
 	{
 		while (TimeCount<lasttimecount+DEMOTICS)
 			SDL_Delay(1);
@@ -493,21 +481,17 @@ void PollControls (void)
 	if (demoplayback)
 	{
 	//
-	// read commands from demo buffer
+	// read commands from demo
 	//
-		buttonbits = *demoptr++;
+		if (DemoReadTic (&buttonbits,&controlx,&controly))
+			playstate = ex_completed;		// demo is done
+
 		for (i=0;i<NUMBUTTONS;i++)
 		{
 			buttonstate[i] = buttonbits&1;
 			buttonbits >>= 1;
 		}
 
-		controlx = *demoptr++;
-		controly = *demoptr++;
-
-		if (demoptr == lastdemoptr)
-			playstate = ex_completed;		// demo is done
-
 		controlx *= (int)tics;
 		controly *= (int)tics;
 
@@ -555,7 +539,7 @@ void PollControls (void)
 	if (demorecord)
 	{
 	//
-	// save info out to demo buffer
+	// save info out to demo
 	//
 		controlx /= (int)tics;
 		controly /= (int)tics;
@@ -569,12 +553,7 @@ void PollControls (void)
 				buttonbits |= 1;
 		}
 
-		*demoptr++ = buttonbits;
-		*demoptr++ = controlx;
-		*demoptr++ = controly;
-
-		if (demoptr >= lastdemoptr)
-			Quit ("Demo buffer overflowed!");
+		DemoWriteTic (buttonbits,controlx,controly);
 
 		controlx *= (int)tics;
 		controly *= (int)tics;
@@ -847,16 +826,36 @@ void CheckKeys (void)
 
 #############################################################################
 
-objlist containt structures for every actor currently playing.  The structure
-is accessed as a linked list starting at *player, ending when ob->next ==
-NULL.  GetNewObj inserts a new object at the end of the list, meaning that
-if an actor spawn another actor, the new one WILL get to think and react the
-same frame.  RemoveObj unlinks the given object and returns it to the free
-list, but does not damage the objects ->next pointer, so if the current object
-removes itself, a linked list following loop can still safely get to the
-next element.
-
-<backwardly linked free list>
+objlist containt structures for every actor currently playing.  Actors
+never move once spawned, so an objlist slot is a stable handle; actorat
+holds ACTORHANDLE (slot+256) for the actor standing on a tile.  objorder
+lists the live slots in spawn order, objorder[0] is always the player.
+GetNewActor appends a new slot, meaning that if an actor spawn another
+actor, the new one WILL get to think and react the same frame.  RemoveObj
+closes the gap in objorder and pushes the slot on the free stack.
+
+The fields every pass over the actors touches, x, y, tilex, tiley, state
+and ticcount, live in objhot by slot and are reached through HOT(ob); the
+rest of objtype is only read by the actor's own routines.  The projection
+TransformActor fills in for the renderer and the attack code lives in the
+act* arrays in WL_DRAW, indexed by slot.
+
+<last in first out free stack>
+
+objorder defines the order actors think in, but DoActors does not walk
+it.  Every actor is also filed on one scheduler list:
+
+sl_pending	spawned since the last filing, thinks this tic if spawned mid pass
+sl_run		active actors, visited every tic
+sl_area		inactive actors, visited only while areabyplayer[area] is set
+sl_wheel	FL_NEVERMARK actors counting down a state with no think routine,
+			bucketed by the actortic the countdown runs out on
+sl_idle		FL_NEVERMARK actors in a state that will never change by itself
+
+A parked actor on sl_run or sl_area is only counting down (or sitting in a
+final state) and just has its actorat mark refreshed.  Its ticcount is
+stale until it wakes; wakeup - actortic is the real value.  NewState wakes
+the actor so anything that changes its state sees normal behaviour.
 
 #############################################################################
 */
@@ -873,28 +872,57 @@ next element.
 =========================
 */
 
-int	objcount;
+//
+// the free slot stack and the scheduler lists belong to the game instance
+//
+#define objfree			(gameinst->objfree)
+#define numobjfree		(gameinst->numobjfree)
+
+#define WHEELMASK	(WHEELSIZE-1)
+#define NEVERWAKE	0x7fffffffl
+
+enum {sl_none,sl_pending,sl_run,sl_area,sl_wheel,sl_idle};
+
+#define actorseq		(gameinst->actorseq)
+#define pendingactors	(gameinst->pendingactors)
+#define runactors		(gameinst->runactors)
+#define idleactors		(gameinst->idleactors)
+#define areaactors		(gameinst->areaactors)
+#define actorwheel		(gameinst->actorwheel)
+
+#define tickorder		(gameinst->tickorder)
+#define numticking		(gameinst->numticking)
+#define tickpos			(gameinst->tickpos)
+#define inactorpass		(gameinst->inactorpass)
+
+static	void	LinkActor (actorlist_t *list, objtype *ob, int schedlist);
+static	void	UnlinkActor (objtype *ob);
 
 void InitActorList (void)
 {
 	int	i;
 
 //
-// init the actor lists
+// init the actor lists, slot 0 on top of the free stack
 //
 	for (i=0;i<MAXACTORS;i++)
-	{
-		objlist[i].prev = &objlist[i+1];
-		objlist[i].next = NULL;
-	}
-
-	objlist[MAXACTORS-1].prev = NULL;
-
-	objfreelist = &objlist[0];
-	lastobj = NULL;
+		objfree[i] = MAXACTORS-1-i;
+	numobjfree = MAXACTORS;
 
 	objcount = 0;
 
+//
+// empty the scheduler
+//
+	memset (&pendingactors,0,sizeof(pendingactors));
+	memset (&runactors,0,sizeof(runactors));
+	memset (&idleactors,0,sizeof(idleactors));
+	memset (areaactors,0,sizeof(areaactors));
+	memset (actorwheel,0,sizeof(actorwheel));
+	actortic = actorseq = 0;
+	numticking = 0;
+	inactorpass = false;
+
 //
 // give the player the first free spots
 //
@@ -911,7 +939,7 @@ void InitActorList (void)
 = GetNewActor
 =
 = Sets the global variable new to point to a free spot in objlist.
-= The free spot is inserted at the end of the liked list
+= The free spot is added at the end of objorder
 =
 = When the object list is full, the caller can either have it bomb out ot
 = return a dummy object pointer that will never get used
@@ -921,21 +949,25 @@ void InitActorList (void)
 
 void GetNewActor (void)
 {
-	if (!objfreelist)
+	int	slot;
+
+	if (!numobjfree)
 		Quit ("GetNewActor: No free spots in objlist!");
 
-	new = objfreelist;
-	objfreelist = new->prev;
+	slot = objfree[--numobjfree];
+	new = &objlist[slot];
 	memset (new,0,sizeof(*new));
+	memset (&objhot[slot],0,sizeof(objhot[slot]));
 
-	if (lastobj)
-		lastobj->next = new;
-	new->prev = lastobj;	// new->next is allready NULL from memset
+	actviewx[slot] = 0;
+	actviewheight[slot] = 0;
+	acttransx[slot] = acttransy[slot] = 0;
 
 	new->active = false;
-	lastobj = new;
+	objorder[objcount++] = slot;
 
-	objcount++;
+	new->seq = actorseq++;
+	LinkActor (&pendingactors,new,sl_pending);
 }
 
 //===========================================================================
@@ -945,43 +977,318 @@ void GetNewActor (void)
 =
 = RemoveObj
 =
-= Add the given object back into the free list, and unlink it from it's
-= neighbors
+= Add the given object back onto the free stack, and close its gap in
+= objorder
 =
 =========================
 */
 
 void RemoveObj (objtype *gone)
 {
-	objtype **spotat;
+	int	slot,i;
 
 	if (gone == player)
 		Quit ("RemoveObj: Tried to remove the player!");
 
-	gone->state = NULL;
+	HOT(gone)->state = NULL;
+	UnlinkActor (gone);
 
-//
-// fix the next object's back link
-//
-	if (gone == lastobj)
-		lastobj = (objtype *)gone->prev;
+	slot = gone-objlist;
+	for (i=objcount-1;objorder[i] != slot;i--)
+		;
+	objcount--;
+	memmove (&objorder[i],&objorder[i+1],objcount-i);
+
+	objfree[numobjfree++] = slot;
+}
+
+/*
+=============================================================================
+
+						ACTOR SCHEDULING
+
+=============================================================================
+*/
+
+/*
+=========================
+=
+= LinkActor / UnlinkActor
+=
+= Scheduler lists are kept in spawn order, new actors go on the tail
+=
+=========================
+*/
+
+static actorlist_t *ActorList (objtype *ob)
+{
+	switch (ob->schedlist)
+	{
+	case sl_pending:
+		return &pendingactors;
+	case sl_run:
+		return &runactors;
+	case sl_area:
+		return &areaactors[ob->schedarea];
+	case sl_wheel:
+		return &actorwheel[ob->wakeup&WHEELMASK];
+	case sl_idle:
+		return &idleactors;
+	}
+	return NULL;
+}
+
+static void LinkActor (actorlist_t *list, objtype *ob, int schedlist)
+{
+	objtype	*after;
+
+	after = list->tail;
+	while (after && after->seq > ob->seq)
+		after = after->schedprev;
+
+	ob->schedprev = after;
+	if (after)
+	{
+		ob->schednext = after->schednext;
+		after->schednext = ob;
+	}
+	else
+	{
+		ob->schednext = list->head;
+		list->head = ob;
+	}
+
+	if (ob->schednext)
+		ob->schednext->schedprev = ob;
 	else
-		gone->next->prev = gone->prev;
+		list->tail = ob;
 
-//
-// fix the previous object's forward link
-//
-	gone->prev->next = gone->next;
+	ob->schedlist = schedlist;
+}
 
-//
-// add it back in to the free list
-//
-	gone->prev = objfreelist;
-	objfreelist = gone;
 
-	objcount--;
+static void UnlinkActor (objtype *ob)
+{
+	actorlist_t	*list;
+
+	list = ActorList (ob);
+	if (!list)
+		return;
+
+	if (ob->schedprev)
+		ob->schedprev->schednext = ob->schednext;
+	else
+		list->head = ob->schednext;
+
+	if (ob->schednext)
+		ob->schednext->schedprev = ob->schedprev;
+	else
+		list->tail = ob->schedprev;
+
+	ob->schednext = ob->schedprev = NULL;
+	ob->schedlist = sl_none;
+}
+
+
+/*
+=========================
+=
+= MoveActor
+=
+= Files an actor on list, leaving it where it is if it's already there:
+= lists are in spawn order, so it's in the right place, and relinking it
+= would walk back from the tail to find that place again
+=
+=========================
+*/
+
+static void MoveActor (objtype *ob, actorlist_t *list, int schedlist)
+{
+	if (ActorList (ob) == list)
+		return;
+
+	UnlinkActor (ob);
+	LinkActor (list,ob,schedlist);
+}
+
+
+/*
+=========================
+=
+= FileVisited
+=
+= Active actors go on sl_run, inactive ones on their area's list.  An actor
+= standing outside the area tiles is left to DoActor's own check.
+=
+=========================
+*/
+
+static void FileVisited (objtype *ob)
+{
+	if (ob->active || ob->areanumber >= NUMAREAS)
+		MoveActor (ob,&runactors,sl_run);
+	else
+	{
+		MoveActor (ob,&areaactors[ob->areanumber],sl_area);
+		ob->schedarea = ob->areanumber;
+	}
+}
+
+
+/*
+=========================
+=
+= FileActor
+=
+= Puts an actor on the list that matches what DoActor would do with it.
+= now is the actortic its ticcount counts down from.  Most actors are
+= already on it from the tic before and stay put.
+=
+=========================
+*/
+
+static void FileActor (objtype *ob, long now)
+{
+	long	wakeup;
+
+	ob->parked = false;
+
+	if (!HOT(ob)->state->think)
+	{
+		if (!HOT(ob)->ticcount)
+		{
+			//
+			// final state, nothing will change until something calls NewState
+			//
+			ob->parked = true;
+			if (ob->flags&FL_NEVERMARK)
+			{
+				MoveActor (ob,&idleactors,sl_idle);
+				ob->wakeup = NEVERWAKE;
+				return;
+			}
+			ob->wakeup = NEVERWAKE;
+		}
+		else if (ob->active)
+		{
+			//
+			// only counting down to the end of state action
+			//
+			ob->parked = true;
+			wakeup = now+HOT(ob)->ticcount;
+			if (ob->flags&FL_NEVERMARK)
+			{
+				MoveActor (ob,&actorwheel[wakeup&WHEELMASK],sl_wheel);
+				ob->wakeup = wakeup;
+				return;
+			}
+			ob->wakeup = wakeup;
+		}
+	}
+
+	FileVisited (ob);
+}
+
+
+/*
+=========================
+=
+= TickLater
+=
+= Inserts an actor that was skipped this tic into the remaining tick order
+= if the old list walk would still have reached it
+=
+=========================
+*/
+
+static void TickLater (objtype *ob)
+{
+	int	i;
+
+	if (!inactorpass || tickorder[tickpos]->seq > ob->seq)
+		return;
+
+	for (i=numticking;i>tickpos+1 && tickorder[i-1]->seq > ob->seq;i--)
+		tickorder[i] = tickorder[i-1];
+	tickorder[i] = ob;
+	numticking++;
+}
+
+
+/*
+=========================
+=
+= ActivateActor
+=
+= Called when an actor is seen, moves it off the area lists
+=
+=========================
+*/
+
+void ActivateActor (objtype *ob)
+{
+	if (ob->active)
+		return;
+
+	ob->active = true;
+	if (ob->schedlist == sl_area)
+	{
+		UnlinkActor (ob);
+		LinkActor (&runactors,ob,sl_run);
+	}
+}
+
+
+/*
+=========================
+=
+= WakeActor
+=
+= Called by NewState, the actor's ticcount is valid again
+=
+=========================
+*/
+
+void WakeActor (objtype *ob)
+{
+	if (!ob->parked)
+		return;
+
+	ob->parked = false;
+	if (ob->schedlist != sl_wheel && ob->schedlist != sl_idle)
+		return;						// still visited every tic
+
+	UnlinkActor (ob);
+	FileVisited (ob);
+	TickLater (ob);
 }
 
+
+/*
+=========================
+=
+= SyncActorTics
+=
+= Brings parked ticcounts up to date so the objlist can be saved
+=
+=========================
+*/
+
+void SyncActorTics (void)
+{
+	objtype	*ob;
+	int		i;
+
+	for (i=0;i<objcount;i++)
+	{
+		ob = ORDERACTOR(i);
+		if (ob->parked && ob->wakeup != NEVERWAKE)
+			HOT(ob)->ticcount = ob->wakeup - actortic;
+	}
+}
+
+//==========================================================================
+
 /*
 =============================================================================
 
@@ -1054,10 +1361,8 @@ void StartMusic(void)
 =============================================================================
 */
 
-#define NUMREDSHIFTS	6
 #define REDSTEPS		8
 
-#define NUMWHITESHIFTS	3
 #define WHITESTEPS		20
 #define WHITETICS		6
 
@@ -1065,8 +1370,10 @@ void StartMusic(void)
 byte	far redshifts[NUMREDSHIFTS][768];
 byte	far whiteshifts[NUMREDSHIFTS][768];
 
-int		damagecount,bonuscount;
-boolean	palshifted;
+#define damagecount		(gameinst->damagecount)
+#define bonuscount		(gameinst->bonuscount)
+#define palshifted		(gameinst->palshifted)
+#define palshift		(gameinst->palshift)
 
 extern 	byte	gamepal[768];
 
@@ -1132,6 +1439,7 @@ void InitRedShifts (void)
 void ClearPaletteShifts (void)
 {
 	bonuscount = damagecount = 0;
+	palshift = 0;
 }
 
 
@@ -1201,27 +1509,49 @@ void UpdatePaletteShifts (void)
 	else
 		red = 0;
 
+	palshift = red ? red : -white;
+
+	if (simonly)
+		return;					// nothing on screen to shift
+
+//
+// the shift is picked up by the next present, nothing waits for it
+//
 	if (red)
 	{
-		VW_WaitVBL(1);
-		VL_SetPalette (redshifts[red-1]);
+		VL_SetShift (redshifts[red-1]);
 		palshifted = true;
 	}
 	else if (white)
 	{
-		VW_WaitVBL(1);
-		VL_SetPalette (whiteshifts[white-1]);
+		VL_SetShift (whiteshifts[white-1]);
 		palshifted = true;
 	}
 	else if (palshifted)
 	{
-		VW_WaitVBL(1);
-		VL_SetPalette (&gamepal);		// back to normal
+		VL_SetShift (NULL);				// back to normal
 		palshifted = false;
 	}
 }
 
 
+/*
+=====================
+=
+= PaletteShift
+=
+= The shift the last UpdatePaletteShifts picked: a red shift
+= 1-NUMREDSHIFTS, minus a white shift, or 0
+=
+=====================
+*/
+
+int PaletteShift (void)
+{
+	return palshift;
+}
+
+
 /*
 =====================
 =
@@ -1234,11 +1564,11 @@ void UpdatePaletteShifts (void)
 
 void FinishPaletteShifts (void)
 {
+	palshift = 0;
 	if (palshifted)
 	{
 		palshifted = 0;
-		VW_WaitVBL(1);
-		VL_SetPalette (&gamepal);
+		VL_SetShift (NULL);
 	}
 }
 
@@ -1263,24 +1593,27 @@ void FinishPaletteShifts (void)
 void DoActor (objtype *ob)
 {
 	void (*think)(objtype *);
+	objhot_t	*hot;
 
 	if (!ob->active && !areabyplayer[ob->areanumber])
 		return;
 
+	hot = HOT(ob);
+
 	if (!(ob->flags&(FL_NONMARK|FL_NEVERMARK)) )
-		actorat[ob->tilex][ob->tiley] = NULL;
+		actorat[hot->tilex][hot->tiley] = 0;
 
 //
 // non transitional object
 //
 
-	if (!ob->ticcount)
+	if (!hot->ticcount)
 	{
-		think =	ob->state->think;
+		think =	hot->state->think;
 		if (think)
 		{
 			think (ob);
-			if (!ob->state)
+			if (!hot->state)
 			{
 				RemoveObj (ob);
 				return;
@@ -1290,56 +1623,56 @@ void DoActor (objtype *ob)
 		if (ob->flags&FL_NEVERMARK)
 			return;
 
-		if ( (ob->flags&FL_NONMARK) && actorat[ob->tilex][ob->tiley])
+		if ( (ob->flags&FL_NONMARK) && actorat[hot->tilex][hot->tiley])
 			return;
 
-		actorat[ob->tilex][ob->tiley] = ob;
+		actorat[hot->tilex][hot->tiley] = ACTORHANDLE(ob);
 		return;
 	}
 
 //
 // transitional object
 //
-	ob->ticcount-=tics;
-	while ( ob->ticcount <= 0)
+	hot->ticcount-=tics;
+	while ( hot->ticcount <= 0)
 	{
-		think = ob->state->action;			// end of state action
+		think = hot->state->action;			// end of state action
 		if (think)
 		{
 			think (ob);
-			if (!ob->state)
+			if (!hot->state)
 			{
 				RemoveObj (ob);
 				return;
 			}
 		}
 
-		ob->state = ob->state->next;
+		hot->state = hot->state->next;
 
-		if (!ob->state)
+		if (!hot->state)
 		{
 			RemoveObj (ob);
 			return;
 		}
 
-		if (!ob->state->tictime)
+		if (!hot->state->tictime)
 		{
-			ob->ticcount = 0;
+			hot->ticcount = 0;
 			goto think;
 		}
 
-		ob->ticcount += ob->state->tictime;
+		hot->ticcount += hot->state->tictime;
 	}
 
 think:
 	//
 	// think
 	//
-	think =	ob->state->think;
+	think =	hot->state->think;
 	if (think)
 	{
 		think (ob);
-		if (!ob->state)
+		if (!hot->state)
 		{
 			RemoveObj (ob);
 			return;
@@ -1349,10 +1682,125 @@ think:
 	if (ob->flags&FL_NEVERMARK)
 		return;
 
-	if ( (ob->flags&FL_NONMARK) && actorat[ob->tilex][ob->tiley])
+	if ( (ob->flags&FL_NONMARK) && actorat[hot->tilex][hot->tiley])
 		return;
 
-	actorat[ob->tilex][ob->tiley] = ob;
+	actorat[hot->tilex][hot->tiley] = ACTORHANDLE(ob);
+}
+
+
+/*
+=====================
+=
+= DoActors
+=
+= Runs DoActor on every actor the old objlist walk would have changed, in
+= the same order.  Inactive actors in areas the player can't reach, and
+= actors only waiting out a state, are skipped.
+=
+=====================
+*/
+
+void DoActors (void)
+{
+	objtype	*ob,*next;
+	objtype	*merge[NUMAREAS+1];
+	long	endtic,tic;
+	int		i,area,numlists,first;
+
+	endtic = actortic+tics;
+
+//
+// file anything spawned between passes
+//
+	while (pendingactors.head)
+		FileActor (pendingactors.head,actortic);
+
+//
+// wake countdowns that run out this tic
+//
+	for (tic = actortic+1;tic <= endtic;tic++)
+		for (ob = actorwheel[tic&WHEELMASK].head;ob;ob = next)
+		{
+			next = ob->schednext;
+			if (ob->wakeup > endtic)
+				continue;					// a later lap of the wheel
+
+			UnlinkActor (ob);
+			HOT(ob)->ticcount = ob->wakeup - actortic;
+			ob->parked = false;
+			LinkActor (&runactors,ob,sl_run);
+		}
+
+//
+// gather the actors that can act, in spawn order: sl_run and the lists of
+// the areas the player can reach are each in spawn order already, so they
+// are merged
+//
+	numlists = 0;
+	if (runactors.head)
+		merge[numlists++] = runactors.head;
+	for (area=0;area<NUMAREAS;area++)
+		if (areabyplayer[area] && areaactors[area].head)
+			merge[numlists++] = areaactors[area].head;
+
+	numticking = 0;
+	while (numlists)
+	{
+		first = 0;
+		for (i=1;i<numlists;i++)
+			if (merge[i]->seq < merge[first]->seq)
+				first = i;
+
+		tickorder[numticking++] = merge[first];
+		merge[first] = merge[first]->schednext;
+		if (!merge[first])
+			merge[first] = merge[--numlists];
+	}
+
+//
+// think
+//
+	inactorpass = true;
+	for (tickpos=0;tickpos<numticking;tickpos++)
+	{
+		ob = tickorder[tickpos];
+
+		if (ob->parked)
+		{
+			if (endtic < ob->wakeup)
+			{
+				//
+				// leave the same mark DoActor would
+				//
+				if (!ob->active && !areabyplayer[ob->areanumber])
+					continue;
+				if ( !(ob->flags&FL_NONMARK) || !actorat[HOT(ob)->tilex][HOT(ob)->tiley])
+					actorat[HOT(ob)->tilex][HOT(ob)->tiley] = ACTORHANDLE(ob);
+				continue;
+			}
+			HOT(ob)->ticcount = ob->wakeup - actortic;
+			ob->parked = false;
+		}
+
+		DoActor (ob);
+		if (HOT(ob)->state)
+			FileActor (ob,endtic);
+	}
+	inactorpass = false;
+
+//
+// actors spawned this tic get to think and react the same frame
+//
+	while (pendingactors.head)
+	{
+		ob = pendingactors.head;
+		DoActor (ob);
+		if (HOT(ob)->state)
+			FileActor (ob,endtic);
+	}
+
+	actortic = endtic;
 }
 
 //==========================================================================
@@ -1361,19 +1809,18 @@ think:
 /*
 ===================
 =
-= PlayLoop
+= ResetPlayLoop
+=
+= Clears the play loop state at the start of a level
 =
 ===================
 */
-long funnyticount;
 
-
-void PlayLoop (void)
+void ResetPlayLoop (void)
 {
-	int		give;
-	int	helmetangle;
-
-	playstate = TimeCount = lasttimecount = 0;
+	playstate = lasttimecount = 0;
+	if (!simonly)
+		TimeCount = 0;
 	frameon = 0;
 	running = false;
 	anglefrac = 0;
@@ -1381,6 +1828,117 @@ void PlayLoop (void)
 	funnyticount = 0;
 	memset (buttonstate,0,sizeof(buttonstate));
 	ClearPaletteShifts ();
+}
+
+
+/*
+===================
+=
+= InjectControls
+=
+= Stands in for PollControls when the caller supplies the input.  Bit n of
+= buttonbits is button n, as in a demo record, and xmove/ymove are per tic,
+= bounded the way PollControls bounds them.
+=
+===================
+*/
+
+void InjectControls (byte buttonbits, int xmove, int ymove)
+{
+	int		i;
+
+	memcpy (buttonheld,buttonstate,sizeof(buttonstate));
+
+	for (i=0;i<NUMBUTTONS;i++)
+	{
+		buttonstate[i] = buttonbits&1;
+		buttonbits >>= 1;
+	}
+
+	if (xmove > 100)
+		xmove = 100;
+	else if (xmove < -100)
+		xmove = -100;
+
+	if (ymove > 100)
+		ymove = 100;
+	else if (ymove < -100)
+		ymove = -100;
+
+	controlx = xmove*(int)tics;
+	controly = ymove*(int)tics;
+}
+
+
+/*
+===================
+=
+= ThinkTic
+=
+= Everything in a pass through the play loop before the refresh
+=
+===================
+*/
+
+void ThinkTic (void)
+{
+	madenoise = false;
+
+	MoveDoors ();
+	MovePWalls ();
+
+	DoActors ();
+	GrabBonuses ();
+
+	UpdatePaletteShifts ();
+}
+
+
+/*
+===================
+=
+= FinishTic
+=
+= Everything in a pass through the play loop after the refresh that
+= changes the game
+=
+===================
+*/
+
+void FinishTic (void)
+{
+	//
+	// MAKE FUNNY FACE IF BJ DOESN'T MOVE FOR AWHILE
+	//
+	#ifdef SPEAR
+	funnyticount += tics;
+	if (funnyticount > 30l*70)
+	{
+		funnyticount = 0;
+		StatusDrawPic (17,4,BJWAITING1PIC+(US_RndT()&1));
+		facecount = 0;
+	}
+	#endif
+
+	gamestate.TimeCount+=tics;
+}
+
+
+/*
+===================
+=
+= PlayLoop
+=
+===================
+*/
+
+
+void PlayLoop (void)
+{
+	int		give;
+	int	helmetangle;
+
+	ResetPlayLoop ();
 
 	if (MousePresent)
 		Mouse(MDelta);	// Clear accumulated mouse movement
@@ -1404,38 +1962,23 @@ void PlayLoop (void)
 //
 // actor thinking
 //
-		madenoise = false;
-
-		MoveDoors ();
-		MovePWalls ();
-
-		for (obj = player;obj;obj = obj->next)
-			DoActor (obj);
+		ThinkTic ();
 
-		UpdatePaletteShifts ();
-
-		ThreeDRefresh ();
-
-		//
-		// MAKE FUNNY FACE IF BJ DOESN'T MOVE FOR AWHILE
-		//
-		#ifdef SPEAR
-		funnyticount += tics;
-		if (funnyticount > 30l*70)
-		{
-			funnyticount = 0;
-			StatusDrawPic (17,4,BJWAITING1PIC+(US_RndT()&1));
-			facecount = 0;
-		}
-		#endif
+		if (simonly)
+			SimRefresh ();
+		else
+			ThreeDRefresh ();
 
-		gamestate.TimeCount+=tics;
+		FinishTic ();
 
 		SD_Poll ();
 		UpdateSoundLoc();	// JAB
 
-		if (screenfaded)
-			VW_FadeIn ();
+	//
+	// the fade in runs over the next refreshes while play goes on
+	//
+		if (screenfaded && !simonly && !fading)
+			VL_FadeInBegin (0,255,gamepal,30);
 
 		CheckKeys();
 
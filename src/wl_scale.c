@@ -33,9 +33,10 @@ boolean     insetupscaling;
 
 int         stepbytwo;
 
-int         slinex, slinewidth;
-uint16_t    *linecmds;
-long        linescale;
+THREADLOCAL int         slinex, slinewidth;
+THREADLOCAL uint16_t    *linecmds;
+THREADLOCAL long        linescale;
+THREADLOCAL word        lineid, linedepth;  // aux channel values for the shape
 unsigned    maskword;
 
 //
@@ -108,17 +109,57 @@ void SetupScaling (int maxscaleheight)
 
 //===========================================================================
 
+/*
+=======================
+=
+= ScaleRunColumns
+=
+= One source pixel of ScaleLine, rows top to bottom-1, as a run down each
+= column it covers
+=
+=======================
+*/
+
+static void ScaleRunColumns (int top, int bottom, byte pixel)
+{
+    int x, y, left, right;
+
+    if (top < 0)
+        top = 0;
+    if (bottom > viewheight)
+        bottom = viewheight;
+    if (top >= bottom)
+        return;
+
+    left = slinex < 0 ? 0 : slinex;
+    right = slinex + slinewidth < viewwidth ? slinex + slinewidth : viewwidth;
+
+    for (x = left; x < right; x++)
+    {
+        memset(viewcolumns + x * viewheight + top, pixel, bottom - top);
+        if (auxdepth)
+            for (y = top; y < bottom; y++)
+                auxdepth[y * viewwidth + x] = linedepth;
+        if (auxid)
+            for (y = top; y < bottom; y++)
+                auxid[y * viewwidth + x] = lineid;
+    }
+}
+
+
 /*
 =======================
 =
 = ScaleLine
 =
-= Draws a single scaled sprite column to sdl_framebuffer.
+= Draws a single scaled sprite column to sdl_framebuffer, or to viewargb
+= through viewpal, or down the columns of viewcolumns.
 =
 = Uses the globals: slinex, slinewidth, linecmds, linescale
 =
 = linecmds points to the column segment data within the sprite shape.
 = linescale holds the display height for this sprite.
+= lineid and linedepth go to the aux channels, if they're set.
 =
 = The segment command format (from the t_compshape data) is:
 =   word: end pixel * 2   (0 = end of column)
@@ -190,6 +231,12 @@ void ScaleLine (void)
             if (pixel == 0)
                 continue;   // transparent
 
+            if (viewcolumns)
+            {
+                ScaleRunColumns(screeny_start, screeny_end, pixel);
+                continue;
+            }
+
             for (y = screeny_start; y < screeny_end; y++)
             {
                 if (y < 0)
@@ -204,7 +251,14 @@ void ScaleLine (void)
                 {
                     if (x >= 0 && x < viewwidth)
                     {
-                        sdl_framebuffer[(y + screenofs / 320) * 320 + (screenofs % 320) + x] = pixel;
+                        if (viewargb)
+                            viewargb[y * viewwidth + x] = viewpal[pixel];
+                        else
+                            sdl_framebuffer[(y + screenofs / 320) * 320 + (screenofs % 320) + x] = pixel;
+                        if (auxdepth)
+                            auxdepth[y * viewwidth + x] = linedepth;
+                        if (auxid)
+                            auxid[y * viewwidth + x] = lineid;
                     }
                 }
             }
@@ -251,6 +305,7 @@ void ScaleShape (int xcenter, int shapenum, unsigned height)
     //
     displayheight = scale * 2;
     linescale = displayheight;
+    linedepth = AuxDepth(height);
 
     //
     // Calculate the fixed-point step for mapping 64 source columns to screen pixels
@@ -462,6 +517,7 @@ void SimpleScaleShape (int xcenter, int shapenum, unsigned height)
 
     displayheight = scale * 2;
     linescale = displayheight;
+    linedepth = 0;                          // in front of everything
 
     step = ((long)displayheight << 16) / 64;
 
@@ -82,21 +82,21 @@ boolean	CheckSight (objtype *ob);
 void SpawnNewObj (unsigned tilex, unsigned tiley, statetype *state)
 {
 	GetNewActor ();
-	new->state = state;
+	HOT(new)->state = state;
 	if (state->tictime)
-		new->ticcount = US_RndT () % state->tictime;
+		HOT(new)->ticcount = US_RndT () % state->tictime;
 	else
-		new->ticcount = 0;
+		HOT(new)->ticcount = 0;
 
-	new->tilex = tilex;
-	new->tiley = tiley;
-	new->x = ((long)tilex<<TILESHIFT)+TILEGLOBAL/2;
-	new->y = ((long)tiley<<TILESHIFT)+TILEGLOBAL/2;
+	HOT(new)->tilex = tilex;
+	HOT(new)->tiley = tiley;
+	HOT(new)->x = ((long)tilex<<TILESHIFT)+TILEGLOBAL/2;
+	HOT(new)->y = ((long)tiley<<TILESHIFT)+TILEGLOBAL/2;
 	new->dir = nodir;
 
-	actorat[tilex][tiley] = new;
+	actorat[tilex][tiley] = ACTORHANDLE(new);
 	new->areanumber =
-		*(mapsegs[0] + farmapylookup[new->tiley]+new->tilex) - AREATILE;
+		*(mapsegs[0] + farmapylookup[HOT(new)->tiley]+HOT(new)->tilex) - AREATILE;
 }
 
 
@@ -113,8 +113,9 @@ void SpawnNewObj (unsigned tilex, unsigned tiley, statetype *state)
 
 void NewState (objtype *ob, statetype *state)
 {
-	ob->state = state;
-	ob->ticcount = state->tictime;
+	HOT(ob)->state = state;
+	HOT(ob)->ticcount = state->tictime;
+	WakeActor (ob);
 }
 
 
@@ -159,7 +160,7 @@ void NewState (objtype *ob, statetype *state)
 	{                                               \
 		if (temp<256)                               \
 			return false;                           \
-		if (((objtype *)temp)->flags&FL_SHOOTABLE)  \
+		if (HANDLEACTOR(temp)->flags&FL_SHOOTABLE)  \
 			return false;                           \
 	}                                               \
 }
@@ -173,7 +174,7 @@ void NewState (objtype *ob, statetype *state)
 			return false;                           \
 		if (temp<256)                               \
 			doornum = temp&63;                      \
-		else if (((objtype *)temp)->flags&FL_SHOOTABLE)\
+		else if (HANDLEACTOR(temp)->flags&FL_SHOOTABLE)\
 			return false;                           \
 	}                                               \
 }
@@ -191,39 +192,39 @@ boolean TryWalk (objtype *ob)
 		switch (ob->dir)
 		{
 		case north:
-			ob->tiley--;
+			HOT(ob)->tiley--;
 			break;
 
 		case northeast:
-			ob->tilex++;
-			ob->tiley--;
+			HOT(ob)->tilex++;
+			HOT(ob)->tiley--;
 			break;
 
 		case east:
-			ob->tilex++;
+			HOT(ob)->tilex++;
 			break;
 
 		case southeast:
-			ob->tilex++;
-			ob->tiley++;
+			HOT(ob)->tilex++;
+			HOT(ob)->tiley++;
 			break;
 
 		case south:
-			ob->tiley++;
+			HOT(ob)->tiley++;
 			break;
 
 		case southwest:
-			ob->tilex--;
-			ob->tiley++;
+			HOT(ob)->tilex--;
+			HOT(ob)->tiley++;
 			break;
 
 		case west:
-			ob->tilex--;
+			HOT(ob)->tilex--;
 			break;
 
 		case northwest:
-			ob->tilex--;
-			ob->tiley--;
+			HOT(ob)->tilex--;
+			HOT(ob)->tiley--;
 			break;
 		}
 	}
@@ -233,81 +234,81 @@ boolean TryWalk (objtype *ob)
 		case north:
 			if (ob->obclass == dogobj || ob->obclass == fakeobj)
 			{
-				CHECKDIAG(ob->tilex,ob->tiley-1);
+				CHECKDIAG(HOT(ob)->tilex,HOT(ob)->tiley-1);
 			}
 			else
 			{
-				CHECKSIDE(ob->tilex,ob->tiley-1);
+				CHECKSIDE(HOT(ob)->tilex,HOT(ob)->tiley-1);
 			}
-			ob->tiley--;
+			HOT(ob)->tiley--;
 			break;
 
 		case northeast:
-			CHECKDIAG(ob->tilex+1,ob->tiley-1);
-			CHECKDIAG(ob->tilex+1,ob->tiley);
-			CHECKDIAG(ob->tilex,ob->tiley-1);
-			ob->tilex++;
-			ob->tiley--;
+			CHECKDIAG(HOT(ob)->tilex+1,HOT(ob)->tiley-1);
+			CHECKDIAG(HOT(ob)->tilex+1,HOT(ob)->tiley);
+			CHECKDIAG(HOT(ob)->tilex,HOT(ob)->tiley-1);
+			HOT(ob)->tilex++;
+			HOT(ob)->tiley--;
 			break;
 
 		case east:
 			if (ob->obclass == dogobj || ob->obclass == fakeobj)
 			{
-				CHECKDIAG(ob->tilex+1,ob->tiley);
+				CHECKDIAG(HOT(ob)->tilex+1,HOT(ob)->tiley);
 			}
 			else
 			{
-				CHECKSIDE(ob->tilex+1,ob->tiley);
+				CHECKSIDE(HOT(ob)->tilex+1,HOT(ob)->tiley);
 			}
-			ob->tilex++;
+			HOT(ob)->tilex++;
 			break;
 
 		case southeast:
-			CHECKDIAG(ob->tilex+1,ob->tiley+1);
-			CHECKDIAG(ob->tilex+1,ob->tiley);
-			CHECKDIAG(ob->tilex,ob->tiley+1);
-			ob->tilex++;
-			ob->tiley++;
+			CHECKDIAG(HOT(ob)->tilex+1,HOT(ob)->tiley+1);
+			CHECKDIAG(HOT(ob)->tilex+1,HOT(ob)->tiley);
+			CHECKDIAG(HOT(ob)->tilex,HOT(ob)->tiley+1);
+			HOT(ob)->tilex++;
+			HOT(ob)->tiley++;
 			break;
 
 		case south:
 			if (ob->obclass == dogobj || ob->obclass == fakeobj)
 			{
-				CHECKDIAG(ob->tilex,ob->tiley+1);
+				CHECKDIAG(HOT(ob)->tilex,HOT(ob)->tiley+1);
 			}
 			else
 			{
-				CHECKSIDE(ob->tilex,ob->tiley+1);
+				CHECKSIDE(HOT(ob)->tilex,HOT(ob)->tiley+1);
 			}
-			ob->tiley++;
+			HOT(ob)->tiley++;
 			break;
 
 		case southwest:
-			CHECKDIAG(ob->tilex-1,ob->tiley+1);
-			CHECKDIAG(ob->tilex-1,ob->tiley);
-			CHECKDIAG(ob->tilex,ob->tiley+1);
-			ob->tilex--;
-			ob->tiley++;
+			CHECKDIAG(HOT(ob)->tilex-1,HOT(ob)->tiley+1);
+			CHECKDIAG(HOT(ob)->tilex-1,HOT(ob)->tiley);
+			CHECKDIAG(HOT(ob)->tilex,HOT(ob)->tiley+1);
+			HOT(ob)->tilex--;
+			HOT(ob)->tiley++;
 			break;
 
 		case west:
 			if (ob->obclass == dogobj || ob->obclass == fakeobj)
 			{
-				CHECKDIAG(ob->tilex-1,ob->tiley);
+				CHECKDIAG(HOT(ob)->tilex-1,HOT(ob)->tiley);
 			}
 			else
 			{
-				CHECKSIDE(ob->tilex-1,ob->tiley);
+				CHECKSIDE(HOT(ob)->tilex-1,HOT(ob)->tiley);
 			}
-			ob->tilex--;
+			HOT(ob)->tilex--;
 			break;
 
 		case northwest:
-			CHECKDIAG(ob->tilex-1,ob->tiley-1);
-			CHECKDIAG(ob->tilex-1,ob->tiley);
-			CHECKDIAG(ob->tilex,ob->tiley-1);
-			ob->tilex--;
-			ob->tiley--;
+			CHECKDIAG(HOT(ob)->tilex-1,HOT(ob)->tiley-1);
+			CHECKDIAG(HOT(ob)->tilex-1,HOT(ob)->tiley);
+			CHECKDIAG(HOT(ob)->tilex,HOT(ob)->tiley-1);
+			HOT(ob)->tilex--;
+			HOT(ob)->tiley--;
 			break;
 
 		case nodir:
@@ -326,7 +327,7 @@ boolean TryWalk (objtype *ob)
 
 
 	ob->areanumber =
-		*(mapsegs[0] + farmapylookup[ob->tiley]+ob->tilex) - AREATILE;
+		*(mapsegs[0] + farmapylookup[HOT(ob)->tiley]+HOT(ob)->tilex) - AREATILE;
 
 	ob->distance = TILEGLOBAL;
 	return true;
@@ -376,8 +377,8 @@ void SelectDodgeDir (objtype *ob)
 	else
 		turnaround=opposite[ob->dir];
 
-	deltax = player->tilex - ob->tilex;
-	deltay = player->tiley - ob->tiley;
+	deltax = HOT(player)->tilex - HOT(ob)->tilex;
+	deltay = HOT(player)->tiley - HOT(ob)->tiley;
 
 //
 // arange 5 direction choices in order of preference
@@ -483,8 +484,8 @@ void SelectChaseDir (objtype *ob)
 	olddir=ob->dir;
 	turnaround=opposite[olddir];
 
-	deltax=player->tilex - ob->tilex;
-	deltay=player->tiley - ob->tiley;
+	deltax=HOT(player)->tilex - HOT(ob)->tilex;
+	deltay=HOT(player)->tiley - HOT(ob)->tiley;
 
 	d[1]=nodir;
 	d[2]=nodir;
@@ -590,8 +591,8 @@ void SelectRunDir (objtype *ob)
 	dirtype tdir, olddir, turnaround;
 
 
-	deltax=player->tilex - ob->tilex;
-	deltay=player->tiley - ob->tiley;
+	deltax=HOT(player)->tilex - HOT(ob)->tilex;
+	deltay=HOT(player)->tiley - HOT(ob)->tiley;
 
 	if (deltax<0)
 		d[1]= east;
@@ -664,32 +665,32 @@ void MoveObj (objtype *ob, long move)
 	switch (ob->dir)
 	{
 	case north:
-		ob->y -= move;
+		HOT(ob)->y -= move;
 		break;
 	case northeast:
-		ob->x += move;
-		ob->y -= move;
+		HOT(ob)->x += move;
+		HOT(ob)->y -= move;
 		break;
 	case east:
-		ob->x += move;
+		HOT(ob)->x += move;
 		break;
 	case southeast:
-		ob->x += move;
-		ob->y += move;
+		HOT(ob)->x += move;
+		HOT(ob)->y += move;
 		break;
 	case south:
-		ob->y += move;
+		HOT(ob)->y += move;
 		break;
 	case southwest:
-		ob->x -= move;
-		ob->y += move;
+		HOT(ob)->x -= move;
+		HOT(ob)->y += move;
 		break;
 	case west:
-		ob->x -= move;
+		HOT(ob)->x -= move;
 		break;
 	case northwest:
-		ob->x -= move;
-		ob->y -= move;
+		HOT(ob)->x -= move;
+		HOT(ob)->y -= move;
 		break;
 
 	case nodir:
@@ -704,10 +705,10 @@ void MoveObj (objtype *ob, long move)
 //
 	if (areabyplayer[ob->areanumber])
 	{
-		deltax = ob->x - player->x;
+		deltax = HOT(ob)->x - HOT(player)->x;
 		if (deltax < -MINACTORDIST || deltax > MINACTORDIST)
 			goto moveok;
-		deltay = ob->y - player->y;
+		deltay = HOT(ob)->y - HOT(player)->y;
 		if (deltay < -MINACTORDIST || deltay > MINACTORDIST)
 			goto moveok;
 
@@ -720,32 +721,32 @@ void MoveObj (objtype *ob, long move)
 		switch (ob->dir)
 		{
 		case north:
-			ob->y += move;
+			HOT(ob)->y += move;
 			break;
 		case northeast:
-			ob->x -= move;
-			ob->y += move;
+			HOT(ob)->x -= move;
+			HOT(ob)->y += move;
 			break;
 		case east:
-			ob->x -= move;
+			HOT(ob)->x -= move;
 			break;
 		case southeast:
-			ob->x -= move;
-			ob->y -= move;
+			HOT(ob)->x -= move;
+			HOT(ob)->y -= move;
 			break;
 		case south:
-			ob->y -= move;
+			HOT(ob)->y -= move;
 			break;
 		case southwest:
-			ob->x += move;
-			ob->y -= move;
+			HOT(ob)->x += move;
+			HOT(ob)->y -= move;
 			break;
 		case west:
-			ob->x += move;
+			HOT(ob)->x += move;
 			break;
 		case northwest:
-			ob->x += move;
-			ob->y += move;
+			HOT(ob)->x += move;
+			HOT(ob)->y += move;
 			break;
 
 		case nodir:
@@ -817,8 +818,8 @@ void KillActor (objtype *ob)
 {
 	int	tilex,tiley;
 
-	tilex = ob->tilex = ob->x >> TILESHIFT;		// drop item on center
-	tiley = ob->tiley = ob->y >> TILESHIFT;
+	tilex = HOT(ob)->tilex = HOT(ob)->x >> TILESHIFT;		// drop item on center
+	tiley = HOT(ob)->tiley = HOT(ob)->y >> TILESHIFT;
 
 	switch (ob->obclass)
 	{
@@ -869,22 +870,22 @@ void KillActor (objtype *ob)
 
 	case giftobj:
 		GivePoints (5000);
-		gamestate.killx = player->x;
-		gamestate.killy = player->y;
+		gamestate.killx = HOT(player)->x;
+		gamestate.killy = HOT(player)->y;
 		NewState (ob,&s_giftdie1);
 		break;
 
 	case fatobj:
 		GivePoints (5000);
-		gamestate.killx = player->x;
-		gamestate.killy = player->y;
+		gamestate.killx = HOT(player)->x;
+		gamestate.killy = HOT(player)->y;
 		NewState (ob,&s_fatdie1);
 		break;
 
 	case schabbobj:
 		GivePoints (5000);
-		gamestate.killx = player->x;
-		gamestate.killy = player->y;
+		gamestate.killx = HOT(player)->x;
+		gamestate.killy = HOT(player)->y;
 		NewState (ob,&s_schabbdie1);
 		A_DeathScream(ob);
 		break;
@@ -899,8 +900,8 @@ void KillActor (objtype *ob)
 		break;
 	case realhitlerobj:
 		GivePoints (5000);
-		gamestate.killx = player->x;
-		gamestate.killy = player->y;
+		gamestate.killx = HOT(player)->x;
+		gamestate.killy = HOT(player)->y;
 		NewState (ob,&s_hitlerdie1);
 		A_DeathScream(ob);
 		break;
@@ -943,7 +944,7 @@ void KillActor (objtype *ob)
 
 	gamestate.killcount++;
 	ob->flags &= ~FL_SHOOTABLE;
-	actorat[ob->tilex][ob->tiley] = NULL;
+	actorat[HOT(ob)->tilex][HOT(ob)->tiley] = 0;
 	ob->flags |= FL_NONMARK;
 }
 
@@ -1046,15 +1047,15 @@ boolean CheckLine (objtype *ob)
 	int	xfrac,yfrac,deltafrac;
 	unsigned	value,intercept;
 
-	x1 = ob->x >> UNSIGNEDSHIFT;		// 1/256 tile precision
-	y1 = ob->y >> UNSIGNEDSHIFT;
+	x1 = HOT(ob)->x >> UNSIGNEDSHIFT;		// 1/256 tile precision
+	y1 = HOT(ob)->y >> UNSIGNEDSHIFT;
 	xt1 = x1 >> 8;
 	yt1 = y1 >> 8;
 
 	x2 = plux;
 	y2 = pluy;
-	xt2 = player->tilex;
-	yt2 = player->tiley;
+	xt2 = HOT(player)->tilex;
+	yt2 = HOT(player)->tiley;
 
 
 	xdist = abs(xt2-xt1);
@@ -1198,8 +1199,8 @@ boolean CheckSight (objtype *ob)
 //
 // if the player is real close, sight is automatic
 //
-	deltax = player->x - ob->x;
-	deltay = player->y - ob->y;
+	deltax = HOT(player)->x - HOT(ob)->x;
+	deltay = HOT(player)->y - HOT(ob)->y;
 
 	if (deltax > -MINSIGHT && deltax < MINSIGHT
 	&& deltay > -MINSIGHT && deltay < MINSIGHT)
@@ -0,0 +1,152 @@
+// DEATHCAM.C
+//
+// Kills the boss on each boss map of the registered episodes and steps the
+// library through the death cam, which has to end the level as victorious
+// without the screen work and waits it does in the game.  Run from the
+// directory with the .WL6 data files; without them there's nothing to test.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "wl_def.h"
+#include "wl_lib.h"
+
+#define TICLIMIT	(70*60)			// a minute of game time is plenty
+#define MAXMS		2000			// the game's own waits add up to ~6 s
+
+//
+// episode and map as W3D_Create takes them, 0 based: the bosses with a
+// death cam are all on floor 9 of episodes 2, 3, 4 and 6
+//
+static const struct
+{
+	int			episode,map;
+	classtype	boss;
+} bosses[] =
+{
+	{1,8,schabbobj},
+	{2,8,realhitlerobj},
+	{3,8,giftobj},
+	{5,8,fatobj}
+};
+
+
+/*
+===================
+=
+= KillBoss
+=
+= Kills the boss out from under the instance, through a scratch game
+= restored from its snapshot
+=
+===================
+*/
+
+static int KillBoss (w3d_instance *inst, classtype boss)
+{
+	gameinst_t	*scratch,*oldinst;
+	void		*buffer;
+	objtype		*ob;
+	int			i,found;
+
+	buffer = malloc (W3D_SnapshotSize ());
+	if (!buffer)
+		return 0;
+
+	scratch = GI_NewInstance ();
+	oldinst = gameinst;
+	W3D_Snapshot (inst,buffer);
+	GI_Restore (scratch,buffer);
+	GI_SetInstance (scratch);
+
+	found = 0;
+	for (i=1;i<objcount;i++)
+	{
+		ob = ORDERACTOR(i);
+		if (ob->obclass == boss)
+		{
+			KillActor (ob);
+			found = 1;
+			break;
+		}
+	}
+
+	GI_Snapshot (scratch,buffer);
+	GI_SetInstance (oldinst);
+	W3D_Restore (inst,buffer);
+
+	GI_FreeInstance (scratch);
+	free (buffer);
+	return found;
+}
+
+
+int main (int argc, char **argv)
+{
+	w3d_instance	*inst;
+	w3d_input		input = {0,0,0};
+	FILE			*f;
+	Uint32			start,ms;
+	int				i,tic,state,failed,tested;
+
+	f = fopen ("VSWAP.WL6","rb");
+	if (!f)
+		f = fopen ("vswap.wl6","rb");
+	if (!f)
+	{
+		printf ("deathcam: no .WL6 data files here, skipped\n");
+		return 0;
+	}
+	fclose (f);
+
+	W3D_Init (argc,argv);
+	godmode = true;				// the guards don't get to end it first
+
+	failed = tested = 0;
+	for (i=0;i<sizeof(bosses)/sizeof(bosses[0]);i++)
+	{
+		if (!W3D_LevelExists (bosses[i].episode,bosses[i].map,0))
+			continue;
+
+		inst = W3D_Create (bosses[i].episode,bosses[i].map,0);
+		tested++;
+		if (!KillBoss (inst,bosses[i].boss))
+		{
+			printf ("deathcam: E%dM%d: no boss on the map\n",
+				bosses[i].episode+1,bosses[i].map+1);
+			failed = 1;
+			W3D_Destroy (inst);
+			continue;
+		}
+
+		start = SDL_GetTicks ();
+		state = W3D_PLAYING;
+		for (tic=0;tic<TICLIMIT && state == W3D_PLAYING;tic++)
+			state = W3D_Step (inst,&input,1,0);
+		ms = SDL_GetTicks () - start;
+
+		if (state != W3D_VICTORIOUS)
+		{
+			printf ("deathcam: E%dM%d: state %d after %d tics\n",
+				bosses[i].episode+1,bosses[i].map+1,state,tic);
+			failed = 1;
+		}
+		else if (ms > MAXMS)
+		{
+			printf ("deathcam: E%dM%d: took %u ms\n",
+				bosses[i].episode+1,bosses[i].map+1,(unsigned)ms);
+			failed = 1;
+		}
+		else
+			printf ("deathcam: E%dM%d: victorious after %d tics, %u ms\n",
+				bosses[i].episode+1,bosses[i].map+1,tic,(unsigned)ms);
+
+		W3D_Destroy (inst);
+	}
+
+	W3D_Shutdown ();
+
+	if (!tested)
+		printf ("deathcam: the data files have no boss levels, skipped\n");
+	return failed;
+}